@@ -4,39 +4,55 @@
 #include "Sequence.h"
 #include "DynamicArray.h"
 #include <stdexcept>
+#include <utility>
 
 template <typename T>
 class ArraySequence : public Sequence<T> {
 protected:
     DynamicArray<T> array;
     explicit ArraySequence(const DynamicArray<T>& arr);
+    explicit ArraySequence(DynamicArray<T>&& arr);
     virtual ArraySequence<T>* Instance()=0;
     virtual ArraySequence<T>* Clone()=0;
+    // A new sequence of this kind that takes over arr. The default clones
+    // and then replaces the contents; subclasses can construct directly.
+    virtual ArraySequence<T>* WithArray(DynamicArray<T>&& arr);
 
 public:
     ArraySequence()=default;
-    explicit ArraySequence(int size);
-    ArraySequence(T* items, int count);
+    explicit ArraySequence(std::size_t size);
+    ArraySequence(T* items, std::size_t count);
     ArraySequence(const ArraySequence<T>& other);
     virtual ~ArraySequence()=default;
     T GetFirst() const override;
     T GetLast() const override;
-    T Get(int index) const override;
-    int GetLength() const override;
-    Sequence<T>* GetSubsequence(int startIndex, int endIndex) override;
+    T Get(std::size_t index) const override;
+    std::size_t GetLength() const override;
+    Sequence<T>* GetSubsequence(std::size_t startIndex, std::size_t endIndex) override;
     Sequence<T>* Append(const T& item) override;
     Sequence<T>* Prepend(const T& item) override;
-    Sequence<T>* Insert(const T& item, int index) override;
+    Sequence<T>* Insert(const T& item, std::size_t index) override;
     Sequence<T>* Concat(Sequence<T>* other) override;
+    void CopyRange(std::size_t start, std::size_t count, T* out) const override;
 };
 template <typename T>
 ArraySequence<T>::ArraySequence(const DynamicArray<T>& arr) : array(arr) {}
 
 template <typename T>
-ArraySequence<T>::ArraySequence(int size) : array(size) {}
+ArraySequence<T>::ArraySequence(DynamicArray<T>&& arr) : array(std::move(arr)) {}
 
 template <typename T>
-ArraySequence<T>::ArraySequence(T* items, int count)
+ArraySequence<T>* ArraySequence<T>::WithArray(DynamicArray<T>&& arr) {
+    ArraySequence<T>* result = Clone();
+    result->array = std::move(arr);
+    return result;
+}
+
+template <typename T>
+ArraySequence<T>::ArraySequence(std::size_t size) : array(size) {}
+
+template <typename T>
+ArraySequence<T>::ArraySequence(T* items, std::size_t count)
         : array(DynamicArray<T>(items, count)) {}
 
 template <typename T>
@@ -58,77 +74,62 @@ T ArraySequence<T>::GetLast() const {
 }
 
 template <typename T>
-T ArraySequence<T>::Get(int index) const {
-    if (index < 0 or index>=array.GetSize())
+T ArraySequence<T>::Get(std::size_t index) const {
+    if (index>=array.GetSize())
         throw std::out_of_range("Sequence is empty");
     return array.Get(index);
 }
 
 template <typename T>
-int ArraySequence<T>::GetLength() const {
+std::size_t ArraySequence<T>::GetLength() const {
     return array.GetSize();
 }
 
 template <typename T>
-Sequence<T>* ArraySequence<T>::GetSubsequence(int startIndex, int endIndex) {
-    if (startIndex < 0 || endIndex >= array.GetSize() || startIndex > endIndex)
+Sequence<T>* ArraySequence<T>::GetSubsequence(std::size_t startIndex, std::size_t endIndex) {
+    if (endIndex >= array.GetSize() || startIndex > endIndex)
         throw std::out_of_range("Invalid index range");
-    DynamicArray<T> instance(endIndex-startIndex+1);
-    for (int i=0;i<(endIndex-startIndex+1);i++){
-        instance.Set(i,array.Get(startIndex+i));
-    }
-    ArraySequence<T>* result=Clone();
-    result->array=instance;
-    return result;
-
+    DynamicArray<T> instance(&array.Get(startIndex), endIndex-startIndex+1);
+    return WithArray(std::move(instance));
 }
+// The new element is copy-constructed in place and the tail is shifted by
+// move; nothing is default-constructed first.
 template <typename T>
 Sequence<T>* ArraySequence<T>::Append(const T& item) {
     ArraySequence<T>* instance=Instance();
-    int OldSize=instance->array.GetSize();
-    instance->array.Resize(OldSize + 1);
-    instance->array.Set(OldSize, item);
+    instance->array.Append(item);
     return instance;
 }
 
 template <typename T>
 Sequence<T>* ArraySequence<T>::Prepend(const T& item) {
     ArraySequence<T>* instance=Instance();
-    int OldSize=instance->array.GetSize();
-    instance->array.Resize(OldSize + 1);
-    for (int i = OldSize; i > 0; --i) {
-        instance->array.Set(i, instance->array.Get(i-1));
-    }
-    instance->array.Set(0, item);
+    instance->array.Insert(0, item);
     return instance;
 }
 
 template <typename T>
-Sequence<T>* ArraySequence<T>::Insert(const T& item, int index) {
-    if (index < 0 || index > array.GetSize())
+Sequence<T>* ArraySequence<T>::Insert(const T& item, std::size_t index) {
+    if (index > array.GetSize())
         throw std::out_of_range("Index out of range");
     ArraySequence<T>* instance=Instance();
-    int OldSize=instance->array.GetSize();
-    instance->array.Resize(OldSize + 1);
-    for (int i = OldSize; i > index; --i) {
-        instance->array.Set(i, instance->array.Get(i - 1));
-    }
-    instance->array.Set(index, item);
+    instance->array.Insert(index, item);
     return instance;
 }
 
 template <typename T>
 Sequence<T>* ArraySequence<T>::Concat(Sequence<T>* other) {
-    DynamicArray<T> NewArray(this->GetLength()+other->GetLength());
-    for (int i=0;i<(array.GetSize());i++){
-        NewArray.Set(i,this->Get(i));
-    }
-    for (int i=0;i<(other->GetLength());i++){
-        NewArray.Set(this->GetLength()+i,other->Get(i));
-    }
-    ArraySequence<T>* result=Clone();
-    result->array=NewArray;
-    return result;
+    std::size_t OldSize=array.GetSize();
+    std::size_t OtherSize=other->GetLength();
+    DynamicArray<T> NewArray(OldSize+OtherSize);
+    if (OldSize) array.CopyTo(0, OldSize, &NewArray.Get(0));
+    if (OtherSize) other->CopyRange(0, OtherSize, &NewArray.Get(OldSize));
+    return WithArray(std::move(NewArray));
+}
+
+template <typename T>
+void ArraySequence<T>::CopyRange(std::size_t start, std::size_t count, T* out) const {
+    array.CopyTo(start, count, out);
 }
 
 #endif
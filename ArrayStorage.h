@@ -0,0 +1,403 @@
+#ifndef ARRAYSTORAGE_H
+#define ARRAYSTORAGE_H
+
+#include <stdexcept>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "PoolAllocator.h"
+
+// Room for N elements inside the object; empty when N == 0.
+template <typename T, std::size_t N>
+struct InlineBuffer {
+    alignas(T) unsigned char bytes[N * sizeof(T)];
+    T* inlineData() { return reinterpret_cast<T*>(bytes); }
+    const T* inlineData() const { return reinterpret_cast<const T*>(bytes); }
+};
+
+template <typename T>
+struct InlineBuffer<T, 0> {
+    T* inlineData() { return nullptr; }
+    const T* inlineData() const { return nullptr; }
+};
+
+// Raw element storage behind DynamicArray (N == 0) and SmallDynamicArray.
+// Only the first size slots of data are constructed. data points at the
+// inline buffer until more than N elements are needed, then at a block of
+// capacity elements from Alloc; growth moves the elements (copies only if
+// T's move may throw) into the new block. Trivially copyable elements are
+// copied with memcpy, and a heap block grows through the allocator's
+// reallocate when it has one.
+//
+// The allocator is copied along with the array and travels with the buffer
+// on move. Moving an array whose elements are inline moves them one by one,
+// so a move is only noexcept when N == 0 or T's move constructor is.
+template <typename T, std::size_t N, typename Alloc>
+class ArrayStorage : private Alloc, private InlineBuffer<T, N> {
+    static constexpr bool NothrowMove = N == 0 || std::is_nothrow_move_constructible<T>::value;
+
+public:
+    const T& Get(std::size_t index) const;
+    T& Get(std::size_t index);
+    std::size_t GetSize() const { return size; }
+    void Set(std::size_t index, const T& value);
+    // Assigns elements [start, start + count) to out[0..count).
+    void CopyTo(std::size_t start, std::size_t count, T* out) const;
+
+    void Reserve(std::size_t newCapacity);
+    void Resize(std::size_t NewSize);
+    void Append(const T& value);
+    void Append(T&& value);
+    void Insert(std::size_t index, const T& value);
+    void Insert(std::size_t index, T&& value);
+    template <typename... Args>
+    T& Emplace(Args&&... args);
+
+    bool operator==(const ArrayStorage& other) const {
+        if (size != other.size) return false;
+        if constexpr (BitwiseComparable) {
+            return size == 0 || std::memcmp(data, other.data, size * sizeof(T)) == 0;
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            if (data[i] != other.data[i]) return false;
+        }
+        return true;
+    }
+    bool operator!=(const ArrayStorage& other) const {
+        return !(*this == other);
+    }
+
+    static constexpr std::size_t MaxSize() { return PTRDIFF_MAX / sizeof(T); }
+
+protected:
+    static constexpr bool Trivial = std::is_trivially_copyable<T>::value;
+    static constexpr bool BitwiseComparable = Trivial && std::has_unique_object_representations<T>::value;
+
+    explicit ArrayStorage(const Alloc& alloc = Alloc());
+    ArrayStorage(const ArrayStorage& other);
+    ArrayStorage(ArrayStorage&& other) noexcept(NothrowMove);
+    ArrayStorage& operator=(const ArrayStorage& other);
+    ArrayStorage& operator=(ArrayStorage&& other) noexcept(NothrowMove);
+    ~ArrayStorage();
+
+    // Copies items[0..count), which must not point into this array, onto
+    // the end.
+    void appendRange(const T* items, std::size_t count);
+    bool onHeap() const { return data != this->inlineData(); }
+
+    std::size_t size;
+    std::size_t capacity;
+    T* data;
+
+private:
+    T* allocateElements(std::size_t n);
+    void deallocateElements(T* p, std::size_t n);
+    void destroyAll();
+    void releaseHeap();
+    void relocate(T* to);
+    void stealFrom(ArrayStorage& other);
+    void ensureCapacity(std::size_t minCapacity);
+    void grow();
+};
+
+template <typename T, std::size_t N, typename Alloc>
+T* ArrayStorage<T, N, Alloc>::allocateElements(std::size_t n) {
+    if (n == 0) return nullptr;
+    if (n > MaxSize()) throw std::length_error("DynamicArray: requested size exceeds MaxSize()");
+    return static_cast<T*>(Alloc::allocate(sizeof(T) * n, alignof(T)));
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::deallocateElements(T* p, std::size_t n) {
+    if (p) Alloc::deallocate(p, sizeof(T) * n, alignof(T));
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::destroyAll() {
+    for (std::size_t i = size; i > 0; --i) data[i - 1].~T();
+    size = 0;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::releaseHeap() {
+    if (onHeap()) deallocateElements(data, capacity);
+    data = this->inlineData();
+    capacity = N;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+ArrayStorage<T, N, Alloc>::ArrayStorage(const Alloc& alloc)
+    : Alloc(alloc), size(0), capacity(N), data(this->inlineData())
+{ }
+
+template <typename T, std::size_t N, typename Alloc>
+ArrayStorage<T, N, Alloc>::ArrayStorage(const ArrayStorage& other)
+    : Alloc(static_cast<const Alloc&>(other)), size(0), capacity(N), data(this->inlineData())
+{
+    try {
+        appendRange(other.data, other.size);
+    } catch (...) {
+        destroyAll();
+        releaseHeap();
+        throw;
+    }
+}
+
+template <typename T, std::size_t N, typename Alloc>
+ArrayStorage<T, N, Alloc>::ArrayStorage(ArrayStorage&& other) noexcept(NothrowMove)
+    : Alloc(std::move(static_cast<Alloc&>(other))), size(0), capacity(N), data(this->inlineData())
+{
+    stealFrom(other);
+}
+
+// Reuses the buffer when it is large enough; otherwise the copy is built
+// with this array's allocator and moved in.
+template <typename T, std::size_t N, typename Alloc>
+ArrayStorage<T, N, Alloc>& ArrayStorage<T, N, Alloc>::operator=(const ArrayStorage& other) {
+    if (this == &other) return *this;
+    if (capacity >= other.size) {
+        if constexpr (Trivial) {
+            if (other.size) std::memcpy(static_cast<void*>(data), other.data, other.size * sizeof(T));
+            size = other.size;
+            return *this;
+        }
+        std::size_t i = 0;
+        for (; i < size && i < other.size; ++i) data[i] = other.data[i];
+        for (; i < other.size; ++i, ++size) ::new (static_cast<void*>(data + i)) T(other.data[i]);
+        while (size > other.size) data[--size].~T();
+        return *this;
+    }
+    ArrayStorage copy(static_cast<const Alloc&>(*this));
+    copy.appendRange(other.data, other.size);
+    return *this = std::move(copy);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+ArrayStorage<T, N, Alloc>& ArrayStorage<T, N, Alloc>::operator=(ArrayStorage&& other) noexcept(NothrowMove) {
+    if (this == &other) return *this;
+    destroyAll();
+    releaseHeap();
+    static_cast<Alloc&>(*this) = std::move(static_cast<Alloc&>(other));
+    stealFrom(other);
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+ArrayStorage<T, N, Alloc>::~ArrayStorage() {
+    destroyAll();
+    releaseHeap();
+}
+
+// Moves the elements into to (raw storage of at least size slots) and
+// destroys the originals; the caller re-points data.
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::relocate(T* to) {
+    if constexpr (Trivial) {
+        if (size) std::memcpy(static_cast<void*>(to), data, size * sizeof(T));
+        return;
+    }
+    std::size_t moved = 0;
+    try {
+        for (; moved < size; ++moved)
+            ::new (static_cast<void*>(to + moved)) T(std::move_if_noexcept(data[moved]));
+    } catch (...) {
+        for (std::size_t i = moved; i > 0; --i) to[i - 1].~T();
+        throw;
+    }
+    for (std::size_t i = size; i > 0; --i) data[i - 1].~T();
+}
+
+// Expects *this empty and inline. A heap buffer is taken over as is; inline
+// elements are moved across and other is left empty.
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::stealFrom(ArrayStorage& other) {
+    if (other.onHeap()) {
+        data = other.data;
+        size = other.size;
+        capacity = other.capacity;
+        other.data = other.inlineData();
+        other.size = 0;
+        other.capacity = N;
+        return;
+    }
+    other.relocate(data);
+    size = other.size;
+    other.size = 0;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::ensureCapacity(std::size_t minCapacity) {
+    if (capacity >= minCapacity) return;
+    if (minCapacity > MaxSize()) throw std::length_error("DynamicArray: requested size exceeds MaxSize()");
+    std::size_t doubled = capacity > MaxSize() / 2 ? MaxSize() : capacity * 2;
+    std::size_t newCap = std::max(doubled, minCapacity);
+    if constexpr (Trivial && HasReallocate<Alloc>::value) {
+        if (onHeap()) {
+            data = static_cast<T*>(Alloc::reallocate(data, capacity * sizeof(T), newCap * sizeof(T), alignof(T)));
+            capacity = newCap;
+            return;
+        }
+    }
+    T* newData = allocateElements(newCap);
+    try {
+        relocate(newData);
+    } catch (...) {
+        deallocateElements(newData, newCap);
+        throw;
+    }
+    std::size_t oldSize = size;
+    size = 0;
+    releaseHeap();
+    data = newData;
+    size = oldSize;
+    capacity = newCap;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::grow() {
+    if (capacity >= MaxSize()) throw std::length_error("DynamicArray: requested size exceeds MaxSize()");
+    ensureCapacity(capacity + 1);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::appendRange(const T* items, std::size_t count) {
+    if (count > MaxSize() - size) throw std::length_error("DynamicArray: requested size exceeds MaxSize()");
+    ensureCapacity(size + count);
+    if constexpr (Trivial) {
+        if (count) std::memcpy(static_cast<void*>(data + size), items, count * sizeof(T));
+        size += count;
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i, ++size) ::new (static_cast<void*>(data + size)) T(items[i]);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+const T& ArrayStorage<T, N, Alloc>::Get(std::size_t index) const {
+    if (index >= size) {
+        throw std::out_of_range("DynamicArray::Get: index out of range");
+    }
+    return data[index];
+}
+
+template <typename T, std::size_t N, typename Alloc>
+T& ArrayStorage<T, N, Alloc>::Get(std::size_t index) {
+    if (index >= size) {
+        throw std::out_of_range("DynamicArray::Get: index out of range");
+    }
+    return data[index];
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::Set(std::size_t index, const T& value) {
+    if (index >= size) {
+        throw std::out_of_range("DynamicArray::Set: index out of range");
+    }
+    data[index] = value;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::CopyTo(std::size_t start, std::size_t count, T* out) const {
+    if (start > size || count > size - start) {
+        throw std::out_of_range("DynamicArray::CopyTo: range out of bounds");
+    }
+    if constexpr (Trivial) {
+        if (count) std::memmove(out, data + start, count * sizeof(T));
+        return;
+    }
+    std::copy(data + start, data + start + count, out);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::Reserve(std::size_t newCapacity) {
+    ensureCapacity(newCapacity);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::Resize(std::size_t NewSize) {
+    if (NewSize < size) {
+        while (size > NewSize) data[--size].~T();
+        return;
+    }
+    ensureCapacity(NewSize);
+    for (; size < NewSize; ++size) ::new (static_cast<void*>(data + size)) T();
+}
+
+// value may alias an element of this array, so it is copied into place
+// before the old buffer is released.
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::Append(const T& value) {
+    if (size < capacity) {
+        ::new (static_cast<void*>(data + size)) T(value);
+        ++size;
+        return;
+    }
+    T copy(value);
+    grow();
+    ::new (static_cast<void*>(data + size)) T(std::move(copy));
+    ++size;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::Append(T&& value) {
+    if (size < capacity) {
+        ::new (static_cast<void*>(data + size)) T(std::move(value));
+        ++size;
+        return;
+    }
+    T moved(std::move(value));
+    grow();
+    ::new (static_cast<void*>(data + size)) T(std::move(moved));
+    ++size;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::Insert(std::size_t index, const T& value) {
+    T copy(value);
+    Insert(index, std::move(copy));
+}
+
+// Shifts [index, size) up one slot by move. value is taken over before the
+// buffer can grow, so it may refer to an element of this array.
+template <typename T, std::size_t N, typename Alloc>
+void ArrayStorage<T, N, Alloc>::Insert(std::size_t index, T&& value) {
+    if (index > size) {
+        throw std::out_of_range("DynamicArray::Insert: index out of range");
+    }
+    T item(std::move(value));
+    if (size == capacity) grow();
+    if constexpr (Trivial) {
+        if (index < size) std::memmove(static_cast<void*>(data + index + 1), data + index, (size - index) * sizeof(T));
+        ::new (static_cast<void*>(data + index)) T(item);
+        ++size;
+        return;
+    }
+    if (index == size) {
+        ::new (static_cast<void*>(data + size)) T(std::move(item));
+        ++size;
+        return;
+    }
+    ::new (static_cast<void*>(data + size)) T(std::move(data[size - 1]));
+    ++size;
+    std::move_backward(data + index, data + size - 2, data + size - 1);
+    data[index] = std::move(item);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+template <typename... Args>
+T& ArrayStorage<T, N, Alloc>::Emplace(Args&&... args) {
+    if (size >= capacity) {
+        T value(std::forward<Args>(args)...);
+        grow();
+        ::new (static_cast<void*>(data + size)) T(std::move(value));
+    } else {
+        ::new (static_cast<void*>(data + size)) T(std::forward<Args>(args)...);
+    }
+    return data[size++];
+}
+
+#endif
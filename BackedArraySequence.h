@@ -0,0 +1,134 @@
+#ifndef BACKEDARRAYSEQUENCE_H
+#define BACKEDARRAYSEQUENCE_H
+
+#include "ArraySequence.h"
+#include "SegmentedArray.h"
+#include "MappedDynamicArray.h"
+#include <stdexcept>
+#include <utility>
+
+// Mutable ArraySequence whose elements live in Storage instead of the
+// inherited DynamicArray (which stays empty and never allocates). Storage is
+// any container with DynamicArray's interface; the aliases below cover the
+// ones used as materialised caches of lazy sequences and generators.
+template <typename T, typename Storage>
+class BackedArraySequence : public ArraySequence<T> {
+private:
+    Storage storage;
+
+    ArraySequence<T>* Instance() override {
+        return this;
+    }
+    ArraySequence<T>* Clone() override {
+        return new BackedArraySequence(*this);
+    }
+
+public:
+    BackedArraySequence() = default;
+    explicit BackedArraySequence(Storage store) : storage(std::move(store)) {}
+    BackedArraySequence(T* items, std::size_t count) : storage(items, count) {}
+    BackedArraySequence(const BackedArraySequence& other) : ArraySequence<T>(), storage(other.storage) {}
+
+    T GetFirst() const override;
+    T GetLast() const override;
+    T Get(std::size_t index) const override;
+    std::size_t GetLength() const override;
+    Sequence<T>* GetSubsequence(std::size_t startIndex, std::size_t endIndex) override;
+    Sequence<T>* Append(const T& item) override;
+    Sequence<T>* Prepend(const T& item) override;
+    Sequence<T>* Insert(const T& item, std::size_t index) override;
+    Sequence<T>* Concat(Sequence<T>* other) override;
+    void CopyRange(std::size_t start, std::size_t count, T* out) const override;
+
+    // The element itself, without a copy.
+    const T& At(std::size_t index) const { return storage.Get(index); }
+    Storage& GetStorage() { return storage; }
+};
+
+template <typename T, typename Storage>
+T BackedArraySequence<T, Storage>::GetFirst() const {
+    if (storage.GetSize() == 0)
+        throw std::out_of_range("Sequence is empty");
+    return storage.Get(0);
+}
+
+template <typename T, typename Storage>
+T BackedArraySequence<T, Storage>::GetLast() const {
+    if (storage.GetSize() == 0)
+        throw std::out_of_range("Sequence is empty");
+    return storage.Get(storage.GetSize() - 1);
+}
+
+template <typename T, typename Storage>
+T BackedArraySequence<T, Storage>::Get(std::size_t index) const {
+    if (index >= storage.GetSize())
+        throw std::out_of_range("Index out of range");
+    return storage.Get(index);
+}
+
+template <typename T, typename Storage>
+std::size_t BackedArraySequence<T, Storage>::GetLength() const {
+    return storage.GetSize();
+}
+
+template <typename T, typename Storage>
+Sequence<T>* BackedArraySequence<T, Storage>::GetSubsequence(std::size_t startIndex, std::size_t endIndex) {
+    if (endIndex >= storage.GetSize() || startIndex > endIndex)
+        throw std::out_of_range("Invalid index range");
+    auto* result = new BackedArraySequence();
+    for (std::size_t i = startIndex; i <= endIndex; ++i) result->storage.Append(storage.Get(i));
+    return result;
+}
+
+template <typename T, typename Storage>
+Sequence<T>* BackedArraySequence<T, Storage>::Append(const T& item) {
+    storage.Append(item);
+    return this;
+}
+
+template <typename T, typename Storage>
+Sequence<T>* BackedArraySequence<T, Storage>::Prepend(const T& item) {
+    return Insert(item, 0);
+}
+
+template <typename T, typename Storage>
+Sequence<T>* BackedArraySequence<T, Storage>::Insert(const T& item, std::size_t index) {
+    if (index > storage.GetSize())
+        throw std::out_of_range("Index out of range");
+    if (index == storage.GetSize()) return Append(item);
+    T value(item);
+    std::size_t oldSize = storage.GetSize();
+    storage.Append(storage.Get(oldSize - 1));
+    for (std::size_t i = oldSize - 1; i > index; --i) {
+        storage.Get(i) = std::move(storage.Get(i - 1));
+    }
+    storage.Get(index) = std::move(value);
+    return this;
+}
+
+template <typename T, typename Storage>
+Sequence<T>* BackedArraySequence<T, Storage>::Concat(Sequence<T>* other) {
+    std::size_t n = other->GetLength();
+    DynamicArray<T> items(n);
+    if (n) other->CopyRange(0, n, &items.Get(0));
+    auto* result = new BackedArraySequence(*this);
+    for (std::size_t i = 0; i < n; ++i) result->storage.Append(items.Get(i));
+    return result;
+}
+
+template <typename T, typename Storage>
+void BackedArraySequence<T, Storage>::CopyRange(std::size_t start, std::size_t count, T* out) const {
+    storage.CopyTo(start, count, out);
+}
+
+// Append never copies existing elements and references stay valid across
+// appends; a long memoised prefix grows one block at a time.
+template <typename T>
+using SegmentedArraySequence = BackedArraySequence<T, SegmentedArray<T>>;
+
+// Elements live in a memory-mapped file (trivially copyable T only); see
+// MappedDynamicArray for opening a persistent one.
+template <typename T>
+using MappedArraySequence = BackedArraySequence<T, MappedDynamicArray<T>>;
+
+#endif
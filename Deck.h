@@ -19,18 +19,18 @@ public:
     T PopFront();
     T Front() const;
     T Top() const;
-    T Get(int index) const;
-    int GetSize() const;
+    T Get(std::size_t index) const;
+    std::size_t GetSize() const;
     void Clear();
 };
+// The backing sequence is created by the first push, so an idle Deque
+// (e.g. a Generator's prepend queue) owns no heap memory.
 template <typename T>
-Deque<T>::Deque() {
-    sequence = new LinkedSequenceMutable<T>();
-}
+Deque<T>::Deque() : sequence(nullptr) {}
 
 template <typename T>
-Deque<T>::Deque(const Deque<T>& other) {
-    sequence = new LinkedSequenceMutable<T>(*other.sequence);
+Deque<T>::Deque(const Deque<T>& other) : sequence(nullptr) {
+    if (other.sequence) sequence = new LinkedSequenceMutable<T>(*other.sequence);
 }
 
 template <typename T>
@@ -40,11 +40,13 @@ Deque<T>::~Deque() {
 
 template <typename T>
 void Deque<T>::PushTop(const T& item) {
+    if (!sequence) sequence = new LinkedSequenceMutable<T>();
     sequence->Append(item);
 }
 
 template <typename T>
 void Deque<T>::PushFront(const T& item) {
+    if (!sequence) sequence = new LinkedSequenceMutable<T>();
     sequence->Prepend(item);
 }
 
@@ -81,19 +83,19 @@ T Deque<T>::Top() const {
 }
 
 template <typename T>
-int Deque<T>::GetSize() const {
-    return sequence->GetLength();
+std::size_t Deque<T>::GetSize() const {
+    return sequence ? sequence->GetLength() : 0;
 }
 
+// Dropping the sequence frees its nodes in bulk (see LinkedList::Clear).
 template <typename T>
 void Deque<T>::Clear() {
-    while (GetSize() != 0) {
-        PopFront();
-    }
+    delete sequence;
+    sequence = nullptr;
 }
 template <typename T>
-T Deque<T>::Get(int index) const {
-    if (index < 0 || index >= GetSize()) {
+T Deque<T>::Get(std::size_t index) const {
+    if (index >= GetSize()) {
         throw std::out_of_range("Index out of range");
     }
     return sequence->Get(index);
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+
+#include "PoolAllocator.h"
+
+// Epoch-based reclamation. Readers pin the current epoch for the duration of
+// a traversal (EpochGuard); writers hand unlinked objects to Retire instead
+// of freeing them. An object retired in epoch e is reclaimed once the global
+// epoch reaches e + 2, which can only happen after every thread that was
+// pinned when it was retired has unpinned, so no reader can still be inside
+// it. Pinning is one store on a thread-local record; no shared counter is
+// touched per object visited.
+class EpochDomain {
+public:
+    typedef void (*Reclaimer)(void*);
+
+    static const std::size_t CollectThreshold = 64;
+
+    static EpochDomain& Global() {
+        static EpochDomain* domain = new EpochDomain();
+        return *domain;
+    }
+
+    void Pin() {
+        Local& local = local_();
+        if (local.depth++ > 0) return;
+        std::uint64_t e = epoch.load(std::memory_order_seq_cst);
+        local.record->state.exchange((e << 1) | 1, std::memory_order_seq_cst);
+    }
+
+    void Unpin() {
+        Local& local = local_();
+        if (--local.depth > 0) return;
+        local.record->state.store(0, std::memory_order_release);
+        if (pending.load(std::memory_order_relaxed) >= CollectThreshold) Collect();
+    }
+
+    // The calling thread's record is created here if it does not exist yet,
+    // so the thread drains the domain when it exits (see Local).
+    void Retire(void* p, Reclaimer reclaim) {
+        local_();
+        Retired* r = static_cast<Retired*>(PoolAllocator().allocate(sizeof(Retired), alignof(Retired)));
+        r->object = p;
+        r->reclaim = reclaim;
+        {
+            std::lock_guard<std::mutex> guard(limboLock);
+            r->epoch = epoch.load(std::memory_order_seq_cst);
+            r->next = limbo;
+            limbo = r;
+        }
+        if (pending.fetch_add(1, std::memory_order_relaxed) + 1 >= CollectThreshold) Collect();
+    }
+
+    // Advances the epoch as far as pinned readers allow and reclaims every
+    // retired object that has become safe. Objects retired by the reclaimers
+    // themselves (e.g. the next link of a chain) are picked up by the same
+    // call while the epoch keeps advancing.
+    void Collect() {
+        collect(local_());
+    }
+
+    std::size_t PendingCount() const { return pending.load(std::memory_order_relaxed); }
+
+private:
+    // state is 0 when the owning thread is not pinned, otherwise
+    // (pinned epoch << 1) | 1.
+    struct ThreadRecord {
+        std::atomic<std::uint64_t> state;
+        std::atomic<bool> inUse;
+        ThreadRecord* next;
+        ThreadRecord() : state(0), inUse(true), next(0) {}
+    };
+
+    struct Retired {
+        void* object;
+        Reclaimer reclaim;
+        std::uint64_t epoch;
+        Retired* next;
+    };
+
+    // A thread's record. When the thread exits it unpins and runs a last
+    // collection, so retirements below CollectThreshold are still reclaimed
+    // once no other thread is pinned (the main thread's Local is destroyed
+    // at exit). The PoolAllocator thread cache is set up first so that it
+    // outlives the Local and the reclaimers can still free into it.
+    struct Local {
+        ThreadRecord* record;
+        std::size_t depth;
+        bool collecting;
+
+        Local() : record(nullptr), depth(0), collecting(false) {
+            PoolAllocator().deallocate(PoolAllocator().allocate(sizeof(Retired), alignof(Retired)), sizeof(Retired), alignof(Retired));
+            record = Global().Claim();
+        }
+        ~Local() {
+            depth = 0;
+            record->state.store(0, std::memory_order_release);
+            if (Global().PendingCount() > 0) Global().collect(*this);
+            record->inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    void collect(Local& local) {
+        if (local.collecting) return;
+        local.collecting = true;
+        while (true) {
+            bool advanced = TryAdvance();
+            Retired* ready = TakeReady(epoch.load(std::memory_order_seq_cst));
+            if (!ready && !advanced) break;
+            while (ready) {
+                Retired* next = ready->next;
+                ready->reclaim(ready->object);
+                PoolAllocator().deallocate(ready, sizeof(Retired), alignof(Retired));
+                ready = next;
+            }
+            if (pending.load(std::memory_order_relaxed) == 0) break;
+        }
+        local.collecting = false;
+    }
+
+    EpochDomain() : epoch(2), records(0), limbo(0), pending(0) {}
+
+    static Local& local_() {
+        thread_local Local local;
+        return local;
+    }
+
+    // Records are never freed; a record released by an exited thread is
+    // reused by the next thread that registers.
+    ThreadRecord* Claim() {
+        for (ThreadRecord* r = records.load(std::memory_order_acquire); r; r = r->next) {
+            bool expected = false;
+            if (r->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return r;
+        }
+        ThreadRecord* r = new ThreadRecord();
+        ThreadRecord* head = records.load(std::memory_order_relaxed);
+        do {
+            r->next = head;
+        } while (!records.compare_exchange_weak(head, r, std::memory_order_release, std::memory_order_relaxed));
+        return r;
+    }
+
+    bool TryAdvance() {
+        std::uint64_t e = epoch.load(std::memory_order_seq_cst);
+        for (ThreadRecord* r = records.load(std::memory_order_acquire); r; r = r->next) {
+            std::uint64_t s = r->state.load(std::memory_order_seq_cst);
+            if ((s & 1) && (s >> 1) != e) return false;
+        }
+        return epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+    }
+
+    Retired* TakeReady(std::uint64_t current) {
+        Retired* ready = 0;
+        std::size_t taken = 0;
+        std::lock_guard<std::mutex> guard(limboLock);
+        Retired** link = &limbo;
+        while (*link) {
+            Retired* r = *link;
+            if (r->epoch + 2 <= current) {
+                *link = r->next;
+                r->next = ready;
+                ready = r;
+                ++taken;
+            } else {
+                link = &r->next;
+            }
+        }
+        pending.fetch_sub(taken, std::memory_order_relaxed);
+        return ready;
+    }
+
+    std::atomic<std::uint64_t> epoch;
+    std::atomic<ThreadRecord*> records;
+    std::mutex limboLock;
+    Retired* limbo;
+    std::atomic<std::size_t> pending;
+};
+
+
+// Pins the calling thread's epoch for the guard's lifetime. Guards nest.
+class EpochGuard {
+public:
+    explicit EpochGuard(bool active = true) : active_(active) { if (active_) EpochDomain::Global().Pin(); }
+    ~EpochGuard() { if (active_) EpochDomain::Global().Unpin(); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+private:
+    bool active_;
+};
@@ -5,9 +5,9 @@
 #include <stdexcept>
 #include <optional>
 #include "ArraySequence.h"
-#include "DynamicArray.h"  
+#include "SmallDynamicArray.h"
 #include "SmartPointer.h" 
-#include "Deck.h"        
+#include "RingDeque.h"
 #include "Cardinal.h"   
 #include <optional>
 
@@ -48,8 +48,8 @@ Generator(const SharedPtr<ArraySequence<T>>& materialised_, std::function<T(Sequ
             ++pos;
             return val;
         }
-        if (injHead < static_cast<size_t>(injections.GetSize())) {
-            T val = injections.Get(static_cast<int>(injHead++));
+        if (injHead < injections.GetSize()) {
+            T val = injections.Get(injHead++);
             if (materialised) materialised->Append(val);
             ++pos;
             return val;
@@ -92,7 +92,7 @@ Generator(const SharedPtr<ArraySequence<T>>& materialised_, std::function<T(Sequ
 
         size_t n = len.GetValue();
         for (size_t i = n; i > 0; --i)
-            g->prependQueue.PushFront(seq->Get(static_cast<int>(i - 1)));
+            g->prependQueue.PushFront(seq->Get(i - 1));
         return g;
     }
 
@@ -109,7 +109,7 @@ Generator(const SharedPtr<ArraySequence<T>>& materialised_, std::function<T(Sequ
 
         size_t n = len.GetValue();
         for (size_t i = 0; i < n; ++i)
-            g->injections.Append(seq->Get(static_cast<int>(i)));
+            g->injections.Append(seq->Get(i));
         return g;
     }
 
@@ -126,7 +126,7 @@ Generator(const SharedPtr<ArraySequence<T>>& materialised_, std::function<T(Sequ
 
         size_t n = len.GetValue();
         for (size_t i = 0; i < n; ++i)
-            g->removeValues.Append(seq->Get(static_cast<int>(i)));
+            g->removeValues.Append(seq->Get(i));
         return g;
     }
 
@@ -135,7 +135,7 @@ Generator(const SharedPtr<ArraySequence<T>>& materialised_, std::function<T(Sequ
 private:
 
     bool isRemoved(const T& v) const {
-        for (int i = 0; i < removeValues.GetSize(); ++i)
+        for (size_t i = 0; i < removeValues.GetSize(); ++i)
             if (removeValues.Get(i) == v) return true;
         return false;
     }
@@ -145,8 +145,8 @@ private:
     std::function<T(Sequence<T>*)> rule;      
     long long pos;                             
 
-    DynamicArray<T> injections;                
+    SmallDynamicArray<T, 4> injections;
     size_t injHead;                            
-    Deque<T> prependQueue;                   
-    DynamicArray<T> removeValues;            
+    RingDeque<T> prependQueue;
+    SmallDynamicArray<T, 4> removeValues;
 };
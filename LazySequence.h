@@ -2,21 +2,25 @@
 
 #include <cstddef>
 #include <utility>
+#include <algorithm>
 #include <new>
 #include <typeinfo>
 #include <cassert>
 #include <iostream>
 #include <functional>
+#include <mutex>
 #include <stdexcept>
 #include <optional>
 #include <string>
 #include "ArraySequence.h"
 #include "DynamicArray.h"
+#include "SmallDynamicArray.h"
 #include "SmartPointer.h"
 #include "Cardinal.h"
 #include "Generator.h"
 #include "MutableArraySequence.h"
 #include "ImmutableArraySequence.h"
+#include "BackedArraySequence.h"
 
 
 template <class T> class LazySequenceBase;
@@ -28,8 +32,26 @@ template <class T, class R> class MapLazySequence;
 template <class T> class WhereLazySequence;
 template <class T, class U> class ZipLazySequence;
 
+// Define LAZYSEQUENCE_INTRUSIVE_NODES to keep each node's reference count
+// inside the node itself (RefCounted) rather than in a control block placed
+// in front of it. Nodes can then also be held by IntrusivePtr.
+#ifdef LAZYSEQUENCE_INTRUSIVE_NODES
+typedef RefCounted<> LazyNodeBase;
+#else
+struct LazyNodeBase {};
+#endif
+
+// Define LAZYSEQUENCE_SEGMENTED_CACHE to memoise generated elements in a
+// SegmentedArraySequence: a growing cache then never copies its existing
+// elements, at the cost of one extra indirection per Get.
+#ifdef LAZYSEQUENCE_SEGMENTED_CACHE
+template <class T> using MaterialisedStore = SegmentedArraySequence<T>;
+#else
+template <class T> using MaterialisedStore = MutableArraySequence<T>;
+#endif
+
 template <class T>
-class LazySequenceBase {
+class LazySequenceBase : public LazyNodeBase {
 public:
     virtual ~LazySequenceBase() {}
 
@@ -62,14 +84,14 @@ template <class T>
 class CoreLazySequence : public LazySequenceBase<T> {
 public:
     CoreLazySequence() {
-        materialised = MakeShared< MutableArraySequence<T> >();
+        materialised = MakeShared< MaterialisedStore<T> >();
         rule = nullptr;
         wrapperRule = nullptr;
     }
 
-    CoreLazySequence(T* items, int count) {
-        materialised = MakeShared< MutableArraySequence<T> >();
-        for (int i = 0; i < count; ++i) materialised->Append(items[i]);
+    CoreLazySequence(T* items, size_t count) {
+        materialised = MakeShared< MaterialisedStore<T> >();
+        for (size_t i = 0; i < count; ++i) materialised->Append(items[i]);
         rule = nullptr;
         wrapperRule = nullptr;
     }
@@ -77,7 +99,7 @@ public:
     CoreLazySequence(Sequence<T>* seq) {
         ArraySequence<T>* arr = dynamic_cast< ArraySequence<T>* >(seq);
         if (!arr) throw std::runtime_error("CoreLazySequence(Sequence*): only ArraySequence derived supported");
-        materialised = MakeShared< MutableArraySequence<T> >();
+        materialised = MakeShared< MaterialisedStore<T> >();
         size_t n = arr->GetLength(); 
         for (size_t i = 0; i < n; ++i) materialised->Append(arr->Get(i));
         rule = nullptr;
@@ -85,7 +107,7 @@ public:
     }
 
     CoreLazySequence(T (*ruleFunc)(Sequence<T>*), Sequence<T>* seedSeq) {
-        materialised = MakeShared< MutableArraySequence<T> >();
+        materialised = MakeShared< MaterialisedStore<T> >();
         if (seedSeq) {
             ArraySequence<T>* arr = dynamic_cast< ArraySequence<T>* >(seedSeq);
             if (!arr) throw std::runtime_error("CoreLazySequence(rule, seq): only ArraySequence derived supported");
@@ -97,7 +119,7 @@ public:
     }
 
     CoreLazySequence(std::function<T(Sequence<T>*)> ruleFunc, Sequence<T>* seedSeq) {
-        materialised = MakeShared< MutableArraySequence<T> >();
+        materialised = MakeShared< MaterialisedStore<T> >();
         if (seedSeq) {
             ArraySequence<T>* arr = dynamic_cast< ArraySequence<T>* >(seedSeq);
             if (!arr) throw std::runtime_error("CoreLazySequence(std::function, seq): only ArraySequence derived supported");
@@ -108,10 +130,29 @@ public:
         rule = nullptr;
     }
     
+    // The copy's materialised elements become an immutable shared prefix,
+    // which the source adopts as well: later copies of either one (every
+    // Append/Map clones the chain) share that buffer instead of copying the
+    // elements again. A generated sequence keeps growing its store after the
+    // copy, so that store is shared as it is.
     CoreLazySequence(const CoreLazySequence<T>& other) {
-        materialised = MakeShared< MutableArraySequence<T> >();
-        size_t n = other.materialised->GetLength(); 
-        for (size_t i = 0; i < n; ++i) materialised->Append(other.materialised->Get(i));
+        if (other.rule || other.wrapperRule) {
+            prefix = other.prefix;
+            materialised = other.materialised;
+        } else {
+            if (other.materialised->GetLength() != 0) {
+                size_t split = other.prefix.size();
+                size_t tailLength = other.materialised->GetLength();
+                SharedPtr<T[]> extended = MakeSharedArray<T>(split + tailLength);
+                std::copy(other.prefix.begin(), other.prefix.end(), extended.begin());
+                other.materialised->CopyRange(0, tailLength, extended.begin() + split);
+                SharedPtr< ArraySequence<T> > emptyTail = MakeShared< MaterialisedStore<T> >();
+                other.prefix = extended;
+                other.materialised = emptyTail;
+            }
+            prefix = other.prefix;
+            materialised = MakeShared< MaterialisedStore<T> >();
+        }
         rule = other.rule;
         wrapperRule = other.wrapperRule;
         children = other.children;
@@ -125,11 +166,13 @@ public:
     void SetGenerator(std::function<T(Sequence<T>*)> ruleFunc) { wrapperRule = ruleFunc; }
 
     T Get(size_t index) override {
-        size_t n = materialised->GetLength();
-        if (index < n) return materialised->Get(index);
+        size_t split = prefix.size();
+        if (index < split) return prefix[index];
+        size_t n = split + materialised->GetLength();
+        if (index < n) return materialised->Get(index - split);
 
         size_t offset = n;
-        for (int i = 0; i < children.GetSize(); ++i) {
+        for (size_t i = 0; i < children.GetSize(); ++i) {
             Cardinal childLen = children.Get(i)->GetLength();
             if (!childLen.IsOmega() && index < offset + childLen.GetValue())
                 return children.Get(i)->Get(index - offset);
@@ -145,18 +188,18 @@ public:
     Cardinal GetLength() const override {
         if (rule || wrapperRule) return Cardinal::Omega();
         if (children.GetSize() > 0) {
-            for (int i = 0; i < children.GetSize(); ++i) {
+            for (size_t i = 0; i < children.GetSize(); ++i) {
                 Cardinal c = children.Get(i)->GetLength();
                 if (c.IsOmega()) return Cardinal::Omega();
             }
-            size_t sum = materialised->GetLength();
-            for (int i = 0; i < children.GetSize(); ++i) sum += children.Get(i)->GetLength().GetValue();
+            size_t sum = GetMaterializedCount();
+            for (size_t i = 0; i < children.GetSize(); ++i) sum += children.Get(i)->GetLength().GetValue();
             return Cardinal(sum);
         }
-        return Cardinal(materialised->GetLength());
+        return Cardinal(GetMaterializedCount());
     }
 
-    size_t GetMaterializedCount() const override { return materialised->GetLength(); }
+    size_t GetMaterializedCount() const override { return prefix.size() + materialised->GetLength(); }
 
     SharedPtr< LazySequenceBase<T> > Append(const T& item) override {
         return MakeShared< AppendedLazySequence<T> >( this->Clone(), item );
@@ -168,12 +211,28 @@ public:
         return MakeShared< InsertedAtLazySequence<T> >( this->Clone(), item, index );
     }
 
-    SharedPtr< ArraySequence<T> > GetMaterialisedArray() { return materialised; }
+    // Generators extend the array they are given, so a shared prefix is
+    // first copied back, in one bulk copy, into this node's own storage.
+    SharedPtr< ArraySequence<T> > GetMaterialisedArray() {
+        if (!prefix.empty()) {
+            SharedPtr<T[]> whole = prefix;
+            size_t split = prefix.size();
+            size_t tailLength = materialised->GetLength();
+            if (tailLength != 0) {
+                whole = MakeSharedArray<T>(split + tailLength);
+                std::copy(prefix.begin(), prefix.end(), whole.begin());
+                materialised->CopyRange(0, tailLength, whole.begin() + split);
+            }
+            materialised = MakeShared< MaterialisedStore<T> >(whole.begin(), whole.size());
+            prefix.reset();
+        }
+        return materialised;
+    }
     void AddChild(const SharedPtr< LazySequenceBase<T> >& child) { children.Append(child); }
 
     bool HasAnyGenerator() const {
         if (rule || wrapperRule) return true;
-        for (int i = 0; i < children.GetSize(); ++i) {
+        for (size_t i = 0; i < children.GetSize(); ++i) {
             if (children.Get(i)->GetLength().IsOmega()) return true;
         }
         return false;
@@ -181,12 +240,16 @@ public:
 
     T (*GetRawRule())(Sequence<T>*) { return rule; }
     std::function<T(Sequence<T>*)> GetWrapperRule() const { return wrapperRule; }
+    const SharedPtr<T[]>& GetSharedPrefix() const { return prefix; }
 
 private:
-    SharedPtr< ArraySequence<T> > materialised;
+    // Mutable so that copying can move the source's elements into the
+    // shared prefix.
+    mutable SharedPtr<T[]> prefix;
+    mutable SharedPtr< ArraySequence<T> > materialised;
     T (*rule)(Sequence<T>*) = nullptr;
     std::function<T(Sequence<T>*)> wrapperRule = nullptr;
-    DynamicArray< SharedPtr< LazySequenceBase<T> > > children;
+    SmallDynamicArray< SharedPtr< LazySequenceBase<T> >, 2 > children;
 };
 
 template <class T>
@@ -217,7 +280,11 @@ public:
         return Cardinal(bl.GetValue() + 1);
     }
 
-    size_t GetMaterializedCount() const override { return base->GetMaterializedCount() + 1; }
+    // An item appended to an infinite sequence is never reached.
+    size_t GetMaterializedCount() const override {
+        size_t n = base->GetMaterializedCount();
+        return base->GetLength().IsOmega() ? n : n + 1;
+    }
 
     SharedPtr< LazySequenceBase<T> > Append(const T& v) override { return MakeShared< AppendedLazySequence<T> >( this->Clone(), v ); }
     SharedPtr< LazySequenceBase<T> > Prepend(const T& v) override { return MakeShared< PrependedLazySequence<T> >( this->Clone(), v ); }
@@ -298,22 +365,27 @@ template <class T, class R>
 class MapLazySequence : public LazySequenceBase<R> {
 public:
     MapLazySequence(const SharedPtr< LazySequenceBase<T> >& base_, R (*f)(T)) : base(base_), func(f) {}
-    MapLazySequence(const MapLazySequence& other) : base(other.base), func(other.func), cache(other.cache) {}
+    MapLazySequence(const MapLazySequence& other) : base(other.base), func(other.func) {
+        std::lock_guard<std::mutex> guard(other.cacheLock);
+        cache = other.cache;
+    }
 
     SharedPtr< LazySequenceBase<R> > Clone() const override {
         return MakeShared< MapLazySequence<T,R> >(*this);
     }
 
+    // The cache holds f(base[0..n)), so it is filled in order up to index.
     R Get(size_t index) override {
-        if ((size_t)cache.GetSize() > index) return cache.Get((int)index);
-        T v = base->Get(index);
-        R r = func(v);
-        cache.Append(r);
-        return r;
+        std::lock_guard<std::mutex> guard(cacheLock);
+        while (cache.GetSize() <= index) cache.Append(func(base->Get(cache.GetSize())));
+        return cache.Get(index);
     }
 
     Cardinal GetLength() const override { return base->GetLength(); }
-    size_t GetMaterializedCount() const override { return (size_t)cache.GetSize(); }
+    size_t GetMaterializedCount() const override {
+        std::lock_guard<std::mutex> guard(cacheLock);
+        return cache.GetSize();
+    }
 
     SharedPtr< LazySequenceBase<R> > Append(const R& v) override { return MakeShared< AppendedLazySequence<R> >( this->Clone(), v ); }
     SharedPtr< LazySequenceBase<R> > Prepend(const R& v) override { return MakeShared< PrependedLazySequence<R> >( this->Clone(), v ); }
@@ -323,21 +395,29 @@ private:
     SharedPtr< LazySequenceBase<T> > base;
     R (*func)(T);
     DynamicArray<R> cache;
+    mutable std::mutex cacheLock;
 };
 
 template <class T>
 class WhereLazySequence : public LazySequenceBase<T> {
 public:
     WhereLazySequence(const SharedPtr< LazySequenceBase<T> >& base_, bool (*p)(T)) : base(base_), pred(p) {}
-    WhereLazySequence(const WhereLazySequence& other) : base(other.base), pred(other.pred), matches(other.matches) {}
+    WhereLazySequence(const WhereLazySequence& other) : base(other.base), pred(other.pred) {
+        std::lock_guard<std::mutex> guard(other.cacheLock);
+        matches = other.matches;
+    }
 
     SharedPtr< LazySequenceBase<T> > Clone() const override {
         return MakeShared< WhereLazySequence<T> >(*this);
     }
 
     T Get(size_t index) override {
-        ensureFound(index);
-        size_t baseIndex = matches.Get((int)index);
+        size_t baseIndex;
+        {
+            std::lock_guard<std::mutex> guard(cacheLock);
+            ensureFound(index);
+            baseIndex = matches.Get(index);
+        }
         return base->Get(baseIndex);
     }
 
@@ -350,7 +430,10 @@ public:
         return Cardinal(cnt);
     }
 
-    size_t GetMaterializedCount() const override { return (size_t)matches.GetSize(); }
+    size_t GetMaterializedCount() const override {
+        std::lock_guard<std::mutex> guard(cacheLock);
+        return matches.GetSize();
+    }
 
     SharedPtr< LazySequenceBase<T> > Append(const T& v) override { return MakeShared< AppendedLazySequence<T> >( this->Clone(), v ); }
     SharedPtr< LazySequenceBase<T> > Prepend(const T& v) override { return MakeShared< PrependedLazySequence<T> >( this->Clone(), v ); }
@@ -358,30 +441,31 @@ public:
 
 private:
     void ensureFound(size_t idx) {
-        if ((size_t)matches.GetSize() > idx) return;
+        if (matches.GetSize() > idx) return;
         size_t start = (matches.GetSize() == 0) ? 0 : (matches.Get(matches.GetSize()-1) + 1);
         Cardinal bl = base->GetLength();
         size_t cur = start;
         if (bl.IsOmega()) {
-            while ((size_t)matches.GetSize() <= idx) {
+            while (matches.GetSize() <= idx) {
                 T v = base->Get(cur);
                 if (pred(v)) matches.Append(cur);
                 ++cur;
             }
         } else {
             size_t limit = bl.GetValue();
-            while ((size_t)matches.GetSize() <= idx && cur < limit) {
+            while (matches.GetSize() <= idx && cur < limit) {
                 T v = base->Get(cur);
                 if (pred(v)) matches.Append(cur);
                 ++cur;
             }
-            if ((size_t)matches.GetSize() <= idx) throw std::out_of_range("Where: no more elements");
+            if (matches.GetSize() <= idx) throw std::out_of_range("Where: no more elements");
         }
     }
 
     SharedPtr< LazySequenceBase<T> > base;
     bool (*pred)(T);
-    DynamicArray<size_t> matches;
+    SmallDynamicArray<size_t, 8> matches;
+    mutable std::mutex cacheLock;
 };
 
 template <class T, class U>
@@ -441,12 +525,12 @@ SharedPtr< LazySequenceBase<T> > Concat(const SharedPtr< LazySequenceBase<T> >&
 
         T* buf = new T[na + nb];
         for (size_t i = 0; i < na; ++i)
-            buf[i] = a->Get(static_cast<int>(i));
+            buf[i] = a->Get(i);
         for (size_t j = 0; j < nb; ++j)
-            buf[na + j] = b->Get(static_cast<int>(j));
+            buf[na + j] = b->Get(j);
 
         SharedPtr< LazySequenceBase<T> > out =
-            MakeShared< CoreLazySequence<T> >(buf, static_cast<int>(na + nb));
+            MakeShared< CoreLazySequence<T> >(buf, na + nb);
         delete [] buf;
         return out;
     }
@@ -472,9 +556,9 @@ SharedPtr< LazySequenceBase<T> > Concat(const SharedPtr< LazySequenceBase<T> >&
        
         T* buf = new T[na];
         for (size_t i = 0; i < na; ++i)
-            buf[i] = a->Get(static_cast<int>(i));
+            buf[i] = a->Get(i);
 
-        auto out = MakeShared< CoreLazySequence<T> >(buf, static_cast<int>(na));
+        auto out = MakeShared< CoreLazySequence<T> >(buf, na);
         delete [] buf;
         
         out->AddChild(b); 
@@ -487,11 +571,11 @@ SharedPtr< LazySequenceBase<T> > Concat(const SharedPtr< LazySequenceBase<T> >&
 
     T* buf = new T[na + nbSeed];
     for (size_t i = 0; i < na; ++i)
-        buf[i] = a->Get(static_cast<int>(i));
+        buf[i] = a->Get(i);
     for (size_t j = 0; j < nbSeed; ++j)
-        buf[na + j] = bSeed->Get(static_cast<int>(j));
+        buf[na + j] = bSeed->Get(j);
 
-    auto out = MakeShared< CoreLazySequence<T> >(buf, static_cast<int>(na + nbSeed));
+    auto out = MakeShared< CoreLazySequence<T> >(buf, na + nbSeed);
     delete [] buf;
 
     if (rawRuleB) {
@@ -506,41 +590,48 @@ SharedPtr< LazySequenceBase<T> > Concat(const SharedPtr< LazySequenceBase<T> >&
 template <class T>
 class LazySequence {
 public:
-    LazySequence() { root = MakeShared< CoreLazySequence<T> >(); generator.reset(nullptr); }
-    LazySequence(T* items, int count) { root = MakeShared< CoreLazySequence<T> >(items, count); generator.reset(nullptr); }
-    LazySequence(Sequence<T>* seq) { root = MakeShared< CoreLazySequence<T> >(seq); generator.reset(nullptr); }
+    LazySequence() { root.store(MakeShared< CoreLazySequence<T> >()); generator.reset(nullptr); }
+    LazySequence(T* items, size_t count) { root.store(MakeShared< CoreLazySequence<T> >(items, count)); generator.reset(nullptr); }
+    LazySequence(Sequence<T>* seq) { root.store(MakeShared< CoreLazySequence<T> >(seq)); generator.reset(nullptr); }
     LazySequence(T (*ruleFunc)(Sequence<T>*), Sequence<T>* seedSeq) {
         auto core = MakeShared< CoreLazySequence<T> >(ruleFunc, seedSeq);
-        root = core;
+        root.store(core);
         generator = MakeUnique< Generator<T> >( core->GetMaterialisedArray(), ruleFunc );
     }
     LazySequence(std::function<T(Sequence<T>*)> ruleFunc, Sequence<T>* seedSeq) {
         auto core = MakeShared< CoreLazySequence<T> >(ruleFunc, seedSeq);
-        root = core;
+        root.store(core);
         generator = MakeUnique< Generator<T> >( core->GetMaterialisedArray(), ruleFunc );
     }
     LazySequence(const LazySequence<T>& other) {
-        root = other.root;
+        std::lock_guard<std::mutex> guard(other.nodeLock);
+        root.store(other.root.load());
         if (other.generator) generator = MakeUnique< Generator<T> >(*other.generator);
         else generator.reset(nullptr);
     }
 
     void SetGenerator(T (*ruleFunc)(Sequence<T>*)) {
-        CoreLazySequence<T>* core = dynamic_cast< CoreLazySequence<T>* >(root.get());
+        std::lock_guard<std::mutex> guard(nodeLock);
+        SharedPtr< LazySequenceBase<T> > current = root.load();
+        CoreLazySequence<T>* core = dynamic_cast< CoreLazySequence<T>* >(current.get());
         if (!core) throw std::runtime_error("SetGenerator: root is not core");
         core->SetGenerator(ruleFunc);
         generator = MakeUnique< Generator<T> >( core->GetMaterialisedArray(), ruleFunc );
     }
     void SetGenerator(std::function<T(Sequence<T>*)> ruleFunc) {
-        CoreLazySequence<T>* core = dynamic_cast< CoreLazySequence<T>* >(root.get());
+        std::lock_guard<std::mutex> guard(nodeLock);
+        SharedPtr< LazySequenceBase<T> > current = root.load();
+        CoreLazySequence<T>* core = dynamic_cast< CoreLazySequence<T>* >(current.get());
         if (!core) throw std::runtime_error("SetGenerator: root is not core");
         core->SetGenerator(ruleFunc);
         generator = MakeUnique< Generator<T> >( core->GetMaterialisedArray(), ruleFunc );
     }
 
     T Get(size_t index) {
-        if (index < root->GetMaterializedCount()) {
-            return root->Get(index);
+        typename AtomicSharedPtr< LazySequenceBase<T> >::Snapshot current(root);
+        std::lock_guard<std::mutex> guard(nodeLock);
+        if (index < current->GetMaterializedCount()) {
+            return current->Get(index);
         }
 
         if (!generator) {
@@ -549,14 +640,14 @@ public:
             );
         }
 
-        while (root->GetMaterializedCount() <= index) {
+        while (current->GetMaterializedCount() <= index) {
             generator->GetNext();
         }
-        return root->Get(index);
+        return current->Get(index);
     }
 
     T GetFirst() {
-        if (root->GetMaterializedCount() == 0 && !HasGenerator()) {
+        if (GetMaterializedCount() == 0 && !HasGenerator()) {
             throw std::out_of_range("LazySequence::GetFirst: sequence is empty");
         }
         return Get(0);
@@ -574,16 +665,39 @@ public:
         return Get(n - 1);
     }
 
-    SharedPtr< LazySequenceBase<T> > GetRoot() const { return root; }
-    Cardinal GetLength() const { return root->GetLength(); }
-    size_t GetMaterializedCount() const { return root->GetMaterializedCount(); }
+    // The node is read without nodeLock; don't use it while another thread
+    // calls Get.
+    SharedPtr< LazySequenceBase<T> > GetRoot() const { return root.load(); }
+    Cardinal GetLength() const {
+        typename AtomicSharedPtr< LazySequenceBase<T> >::Snapshot current(root);
+        std::lock_guard<std::mutex> guard(nodeLock);
+        return current->GetLength();
+    }
+    size_t GetMaterializedCount() const {
+        typename AtomicSharedPtr< LazySequenceBase<T> >::Snapshot current(root);
+        std::lock_guard<std::mutex> guard(nodeLock);
+        return current->GetMaterializedCount();
+    }
 
-    void AppendValue(const T& v) { root = root->Append(v); }
-    void PrependValue(const T& v) { root = root->Prepend(v); }
-    void InsertAtValue(const T& v, size_t idx) { root = root->InsertAt(v, idx); }
+    // Each edit builds a new node on top of the current root and publishes
+    // it. Building one may copy a core whose store the generator is growing,
+    // so it happens under nodeLock.
+    void AppendValue(const T& v) {
+        std::lock_guard<std::mutex> guard(nodeLock);
+        root.store(root.load()->Append(v));
+    }
+    void PrependValue(const T& v) {
+        std::lock_guard<std::mutex> guard(nodeLock);
+        root.store(root.load()->Prepend(v));
+    }
+    void InsertAtValue(const T& v, size_t idx) {
+        std::lock_guard<std::mutex> guard(nodeLock);
+        root.store(root.load()->InsertAt(v, idx));
+    }
 
     void ConcatWith(const SharedPtr< LazySequenceBase<T> >& other) {
-        SharedPtr< LazySequenceBase<T> > newRoot = Concat(root, other);
+        std::lock_guard<std::mutex> guard(nodeLock);
+        SharedPtr< LazySequenceBase<T> > newRoot = Concat(root.load(), other);
         generator.reset(nullptr);
 
         CoreLazySequence<T>* newCore = dynamic_cast< CoreLazySequence<T>* >(newRoot.get());
@@ -601,22 +715,36 @@ public:
                 );
             }
         }
-        root = newRoot;
+        root.store(newRoot);
     }
 
     template <class R>
     SharedPtr< LazySequenceBase<R> > Map(R (*f)(T)) {
-        return root->template Map<R>(f);
+        std::lock_guard<std::mutex> guard(nodeLock);
+        return root.load()->template Map<R>(f);
+    }
+    SharedPtr< LazySequenceBase<T> > Where(bool (*pred)(T)) {
+        std::lock_guard<std::mutex> guard(nodeLock);
+        return root.load()->Where(pred);
     }
-    SharedPtr< LazySequenceBase<T> > Where(bool (*pred)(T)) { return root->Where(pred); }
 
     bool HasGenerator() const {
-        CoreLazySequence<T>* core = dynamic_cast< CoreLazySequence<T>* >(root.get());
+        std::lock_guard<std::mutex> guard(nodeLock);
+        SharedPtr< LazySequenceBase<T> > current = root.load();
+        CoreLazySequence<T>* core = dynamic_cast< CoreLazySequence<T>* >(current.get());
         if (!core) return false;
         return core->HasAnyGenerator();
     }
 
 private:
-    SharedPtr< LazySequenceBase<T> > root;
+    // Publishing and loading the root is lock-free under
+    // SMARTPOINTER_ATOMIC_REFCOUNT, so GetRoot never blocks; under
+    // SMARTPOINTER_EPOCH_RECLAIM a load only pins an epoch. The nodes are
+    // not immutable, though: the generator appends to the core's store in
+    // place. nodeLock serialises every member that reads or grows them, so
+    // with a thread-safe count policy Get may be called from several threads
+    // while another one edits.
+    AtomicSharedPtr< LazySequenceBase<T> > root;
     UniquePtr< Generator<T> > generator;
+    mutable std::mutex nodeLock;
 };
\ No newline at end of file
@@ -7,10 +7,17 @@
 #include <algorithm>
 #include <utility>
 #include <functional>
+#include <cstdlib>
+#include <new>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include <atomic>
 
 #include "LazySequence.h"
 #include "ArraySequence.h"
 #include "MutableArraySequence.h"
+#include "BackedArraySequence.h"
 #include "SmartPointer.h"
 #include "Cardinal.h"
 
@@ -57,6 +64,49 @@ R Reduce(const SharedPtr< LazySequenceBase<T> >& seq, std::function<R(R, T)> red
     return accumulator;
 }
 
+// Counts calls to the global allocation functions so tests can check that a
+// code path stays off the heap. Every form (scalar, array, aligned, nothrow)
+// is replaced so each allocation is counted and released by its matching
+// deallocation function.
+static std::atomic<size_t> heap_allocations(0);
+
+static void* counted_allocate(size_t n, size_t align) {
+    ++heap_allocations;
+    if (n == 0) n = 1;
+    if (align <= alignof(std::max_align_t)) return std::malloc(n);
+    return std::aligned_alloc(align, (n + align - 1) / align * align);
+}
+// Kept out of line: once inlined, GCC pairs the free() with an operator new
+// call and reports -Wmismatched-new-delete.
+[[gnu::noinline]] static void counted_release(void* p) noexcept { std::free(p); }
+
+static void* counted_allocate_or_throw(size_t n, size_t align) {
+    if (void* p = counted_allocate(n, align)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t n) { return counted_allocate_or_throw(n, 0); }
+void* operator new[](size_t n) { return counted_allocate_or_throw(n, 0); }
+void* operator new(size_t n, std::align_val_t a) { return counted_allocate_or_throw(n, static_cast<size_t>(a)); }
+void* operator new[](size_t n, std::align_val_t a) { return counted_allocate_or_throw(n, static_cast<size_t>(a)); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept { return counted_allocate(n, 0); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return counted_allocate(n, 0); }
+void* operator new(size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return counted_allocate(n, static_cast<size_t>(a)); }
+void* operator new[](size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return counted_allocate(n, static_cast<size_t>(a)); }
+
+void operator delete(void* p) noexcept { counted_release(p); }
+void operator delete[](void* p) noexcept { counted_release(p); }
+void operator delete(void* p, size_t) noexcept { counted_release(p); }
+void operator delete[](void* p, size_t) noexcept { counted_release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_release(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { counted_release(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { counted_release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_release(p); }
+
 static int tests_passed = 0;
 static int tests_failed = 0;
 
@@ -235,6 +285,121 @@ void test_concatwith_preserve_generator() {
     if (v1 != 101) throw std::runtime_error("concatwith_preserve_generator: expected continuation (101)");
 }
 
+
+void test_deep_append_chain_teardown() {
+    const size_t n = 1000000;
+    {
+        LazySequence<int> seq;
+        for (size_t i = 0; i < n; ++i) seq.AppendValue(static_cast<int>(i));
+    }
+    // Reaching this point means the N-deep chain was released without
+    // overflowing the stack.
+}
+
+void test_clone_shares_materialised_prefix() {
+    int buf[] = {1,2,3,4,5,6};
+    CoreLazySequence<int> core(buf, 6);
+
+    SharedPtr< LazySequenceBase<int> > a = core.Clone();
+    SharedPtr< LazySequenceBase<int> > b = a->Clone();
+    for (size_t i = 0; i < 6; ++i) {
+        if (a->Get(i) != static_cast<int>(i + 1) || b->Get(i) != static_cast<int>(i + 1))
+            throw std::runtime_error("value mismatch after cloning");
+    }
+
+    const SharedPtr<int[]>& prefixA = dynamic_cast< CoreLazySequence<int>& >(*a).GetSharedPrefix();
+    const SharedPtr<int[]>& prefixB = dynamic_cast< CoreLazySequence<int>& >(*b).GetSharedPrefix();
+    if (prefixA.size() != 6 || prefixA.get() != prefixB.get())
+        throw std::runtime_error("clone of a clone copied the prefix");
+
+    // The source adopts the prefix too, so cloning it again copies nothing.
+    SharedPtr< LazySequenceBase<int> > c = core.Clone();
+    const SharedPtr<int[]>& prefixC = dynamic_cast< CoreLazySequence<int>& >(*c).GetSharedPrefix();
+    if (core.GetSharedPrefix().get() != prefixA.get() || prefixC.get() != prefixA.get() || prefixA.use_count() != 4)
+        throw std::runtime_error("second clone of the source copied the prefix");
+    if (core.GetMaterializedCount() != 6 || core.Get(5) != 6)
+        throw std::runtime_error("source lost its elements");
+
+    SharedPtr<int[]> whole = MakeSharedArray<int>(6, 7);
+    SharedPtr<int[]> tail = whole.slice(2, 3);
+    tail[0] = 9;
+    if (whole[2] != 9 || tail.size() != 3 || whole.use_count() != 2)
+        throw std::runtime_error("slice does not share the buffer");
+}
+
+void test_empty_sequence_no_heap() {
+    // The first instances warm up the node pool and the epoch/thread records.
+    { LazySequence<int> warm; Generator<int> g(SharedPtr< ArraySequence<int> >(), nullptr); }
+
+    size_t before = heap_allocations;
+    { Generator<int> g(SharedPtr< ArraySequence<int> >(), nullptr); }
+    if (heap_allocations != before) throw std::runtime_error("empty Generator allocated");
+#ifndef SMARTPOINTER_NO_POOL
+    before = heap_allocations;
+    { LazySequence<int> seq; }
+    if (heap_allocations != before) throw std::runtime_error("empty LazySequence allocated");
+#endif
+}
+
+void test_mapped_prefix_survives_reopen() {
+    std::string path = (std::filesystem::temp_directory_path() / "lazy_prefix_test.bin").string();
+    std::remove(path.c_str());
+    {
+        SharedPtr< ArraySequence<int> > cache = MakeShared< MappedArraySequence<int> >(MappedDynamicArray<int>(path));
+        Generator<int> gen(cache, NatRule);
+        for (int i = 0; i < 1000; ++i) gen.GetNext();
+    }
+    MappedArraySequence<int> reopened{MappedDynamicArray<int>(path)};
+    std::remove(path.c_str());
+    if (reopened.GetLength() != 1000 || reopened.Get(999) != 999)
+        throw std::runtime_error("memoised prefix lost on reopen");
+
+    LazySequence<int> seq(NatRule, &reopened);
+    if (seq.Get(1500) != 1500) throw std::runtime_error("generation did not resume from the prefix");
+}
+
+static int epoch_reclaimed = 0;
+
+void test_epoch_drains_below_threshold() {
+    // Far fewer retirements than CollectThreshold: nothing triggers a
+    // collection, so only the worker's exit drain can reclaim them.
+    const int retired = 10;
+    epoch_reclaimed = 0;
+    std::thread worker([] {
+        for (int i = 0; i < retired; ++i)
+            EpochDomain::Global().Retire(nullptr, [](void*) { ++epoch_reclaimed; });
+    });
+    worker.join();
+    if (epoch_reclaimed != retired) throw std::runtime_error("retired objects were not reclaimed at thread exit");
+}
+
+// Sharing a sequence between threads needs thread-safe reference counts.
+#if defined(SMARTPOINTER_ATOMIC_REFCOUNT) || defined(SMARTPOINTER_EPOCH_RECLAIM)
+void test_concurrent_get_while_appending() {
+    // Readers race each other past the materialised prefix, so the generator
+    // runs on whichever thread is ahead, while a writer republishes the root.
+    LazySequence<int> seq(NatRule, nullptr);
+    const int length = 4000;
+    std::atomic<int> mismatches(0);
+
+    std::thread writer([&] {
+        for (int i = 0; i < 200; ++i) seq.AppendValue(-1);
+    });
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&, r] {
+            for (int i = r; i < length; i += 1 + r)
+                if (seq.Get(i) != i) ++mismatches;
+        });
+    }
+    writer.join();
+    for (size_t r = 0; r < readers.size(); ++r) readers[r].join();
+
+    if (mismatches.load() != 0) throw std::runtime_error("concurrent Get returned a wrong element");
+    if (seq.Get(length) != length) throw std::runtime_error("Get past the prefix after appends");
+}
+#endif
+
 int main() {
     std::cout << "Running LazySequence unit tests...\n";
 
@@ -248,6 +413,14 @@ int main() {
     RUN_TEST(test_generator_fib);
     RUN_TEST(test_materialized_count);
     RUN_TEST(test_concatwith_preserve_generator);
+    RUN_TEST(test_deep_append_chain_teardown);
+    RUN_TEST(test_clone_shares_materialised_prefix);
+    RUN_TEST(test_empty_sequence_no_heap);
+    RUN_TEST(test_mapped_prefix_survives_reopen);
+    RUN_TEST(test_epoch_drains_below_threshold);
+#if defined(SMARTPOINTER_ATOMIC_REFCOUNT) || defined(SMARTPOINTER_EPOCH_RECLAIM)
+    RUN_TEST(test_concurrent_get_while_appending);
+#endif
 
     std::cout << "----------------------------------------\n";
     std::cout << "Tests passed: " << tests_passed << "\n";
@@ -5,6 +5,10 @@
 #include <stdexcept>
 #include <string>
 #include <iostream>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include "PoolAllocator.h"
 template <typename T>
 struct Node{
     T key;
@@ -12,62 +16,132 @@ struct Node{
     Node<T>* previous;
     explicit Node(const T& k);
 };
-template <typename T>
-class LinkedList {
+// Nodes come from Alloc (see PoolAllocator.h). The default NodePool gives
+// each list its own slabs, so Clear() and the destructor free all nodes at
+// once instead of one by one; nodes freed by Remove are reused, and their
+// memory is returned only when the list is cleared or destroyed. A copy gets
+// a copy of the source's allocator, which for NodePool is a fresh pool.
+//
+// Append and removal at either end are O(1) through the tail pointer.
+// Index lookups walk from whichever is nearest of the head, the tail and the
+// node found by the previous lookup, so a sequential scan Get(0), Get(1), ...
+// costs O(1) per step. The cursor is updated by const lookups, so concurrent
+// readers of one list need external synchronisation.
+template <typename T, typename Alloc = NodePool>
+class LinkedList : private Alloc {
 public:
     LinkedList();
-    LinkedList(T* items, int count);
-    LinkedList(const LinkedList<T>& list);
+    explicit LinkedList(const Alloc& alloc);
+    LinkedList(T* items, std::size_t count, const Alloc& alloc = Alloc());
+    LinkedList(const LinkedList& list);
+    LinkedList& operator=(const LinkedList& list);
     ~LinkedList();
     void Append(const T& value);
     void Prepend(const T& value);
-    void Insert(const T& value,int index);
-    void Remove(int index);
-    T Get(int index) const;
-    int GetLength() const;
+    void Insert(const T& value,std::size_t index);
+    void Remove(std::size_t index);
+    void Clear();
+    T Get(std::size_t index) const;
+    // Assigns elements [start, start + count) to out[0..count) in one walk.
+    void CopyTo(std::size_t start, std::size_t count, T* out) const;
+    std::size_t GetLength() const;
     T GetFirst() const;
     T GetLast() const;
-    LinkedList<T>* Concat(const LinkedList<T>& list);
-    LinkedList<T>* GetSublist(int startIndex, int endIndex);
+    LinkedList* Concat(const LinkedList& list);
+    LinkedList* GetSublist(std::size_t startIndex, std::size_t endIndex);
 private:
     Node<T>* root;
-    int size;
+    Node<T>* tail;
+    std::size_t size;
+    mutable Node<T>* cursor;
+    mutable std::size_t cursorIndex;
+
+    Node<T>* nodeAt(std::size_t index) const;
+
+    Node<T>* makeNode(const T& value);
+    void freeNode(Node<T>* n);
 };
 template <typename T>
 Node <T>::Node(const T& k):key(k),next(nullptr),previous(nullptr){};
-template <typename T>
-LinkedList<T>::LinkedList():root(nullptr),size(0) {}
-template <typename T>
-LinkedList<T>::LinkedList(T* items, int count) : root(nullptr), size(0) {
-    if (count<0){
-        throw std::invalid_argument("Count must be positive");
+template <typename T, typename Alloc>
+LinkedList<T, Alloc>::LinkedList():root(nullptr),tail(nullptr),size(0),cursor(nullptr),cursorIndex(0) {}
+template <typename T, typename Alloc>
+LinkedList<T, Alloc>::LinkedList(const Alloc& alloc):Alloc(alloc),root(nullptr),tail(nullptr),size(0),cursor(nullptr),cursorIndex(0) {}
+template <typename T, typename Alloc>
+Node<T>* LinkedList<T, Alloc>::makeNode(const T& value) {
+    void* p = Alloc::allocate(sizeof(Node<T>), alignof(Node<T>));
+    try {
+        return ::new (p) Node<T>(value);
+    } catch (...) {
+        Alloc::deallocate(p, sizeof(Node<T>), alignof(Node<T>));
+        throw;
     }
-    for (int i = 0; i < count; ++i) {
+}
+template <typename T, typename Alloc>
+void LinkedList<T, Alloc>::freeNode(Node<T>* n) {
+    n->~Node<T>();
+    Alloc::deallocate(n, sizeof(Node<T>), alignof(Node<T>));
+}
+template <typename T, typename Alloc>
+LinkedList<T, Alloc>::LinkedList(T* items, std::size_t count, const Alloc& alloc)
+    : Alloc(alloc), root(nullptr), tail(nullptr), size(0), cursor(nullptr), cursorIndex(0) {
+    for (std::size_t i = 0; i < count; ++i) {
         Append(items[i]);
     }
 }
-template <typename T>
-LinkedList<T>::LinkedList(const LinkedList<T> &list) {
-    root= nullptr;
-    size=0;
-    if (list.root==nullptr){
-        return;
+template <typename T, typename Alloc>
+LinkedList<T, Alloc>::LinkedList(const LinkedList &list)
+    : Alloc(static_cast<const Alloc&>(list)), root(nullptr), tail(nullptr), size(0), cursor(nullptr), cursorIndex(0) {
+    for (Node<T>* n=list.root; n!=nullptr; n=n->next){
+        Append(n->key);
     }
-    root=new Node<T>(list.root->key);
-    size=1;
-    Node<T>* now=root;
-    Node<T>* n=list.root->next;
-    while (n!= nullptr){
-        now->next=new Node<T>(n->key);
-        now->next->previous=now;
-        now=now->next;
+}
+// Rebuilds the nodes with this list's own allocator, which may own their
+// memory (NodePool); if an element copy throws, the list keeps the elements
+// copied so far.
+template <typename T, typename Alloc>
+LinkedList<T, Alloc>& LinkedList<T, Alloc>::operator=(const LinkedList& list) {
+    if (this == &list) return *this;
+    Clear();
+    for (Node<T>* n=list.root; n!=nullptr; n=n->next){
+        Append(n->key);
+    }
+    return *this;
+}
+// Walks to index from the nearest of head, tail and cursor, and leaves the
+// cursor there.
+template <typename T, typename Alloc>
+Node<T>* LinkedList<T, Alloc>::nodeAt(std::size_t index) const {
+    Node<T>* n=root;
+    std::size_t at=0;
+    std::size_t distance=index;
+    if (size-1-index<distance){
+        n=tail;
+        at=size-1;
+        distance=size-1-index;
+    }
+    if (cursor!=nullptr){
+        std::size_t fromCursor=index>cursorIndex ? index-cursorIndex : cursorIndex-index;
+        if (fromCursor<distance){
+            n=cursor;
+            at=cursorIndex;
+        }
+    }
+    while (at<index){
         n=n->next;
-        size+=1;
+        ++at;
     }
+    while (at>index){
+        n=n->previous;
+        --at;
+    }
+    cursor=n;
+    cursorIndex=index;
+    return n;
 }
-template <typename T>
-LinkedList<T>* LinkedList<T>::Concat(const LinkedList<T>& list) {
-    auto* result = new LinkedList<T>(*this);
+template <typename T, typename Alloc>
+LinkedList<T, Alloc>* LinkedList<T, Alloc>::Concat(const LinkedList& list) {
+    auto* result = new LinkedList(*this);
     Node<T>* current = list.root;
     while (current) {
         result->Append(current->key);
@@ -75,61 +149,82 @@ LinkedList<T>* LinkedList<T>::Concat(const LinkedList<T>& list) {
     }
     return result;
 }
-template <typename T>
-LinkedList<T>* LinkedList<T>::GetSublist(int startIndex, int endIndex) {
-    if (startIndex >= size || startIndex < 0 || endIndex < 0 || endIndex >= size || startIndex > endIndex) {
+template <typename T, typename Alloc>
+LinkedList<T, Alloc>* LinkedList<T, Alloc>::GetSublist(std::size_t startIndex, std::size_t endIndex) {
+    if (startIndex >= size || endIndex >= size || startIndex > endIndex) {
         throw std::out_of_range("Index out of range");
     }
 
-    auto* result = new LinkedList<T>();
-    Node<T>* now = root;
-    for (int i = 0; i < startIndex; ++i) {
-        now = now->next;
-    }
-    for (int i = startIndex; i <= endIndex; ++i) {
+    auto* result = new LinkedList(static_cast<const Alloc&>(*this));
+    Node<T>* now = nodeAt(startIndex);
+    for (std::size_t i = startIndex; i <= endIndex; ++i) {
         result->Append(now->key);
         now = now->next;
     }
     return result;
 }
-template <typename T>
-LinkedList<T>::~LinkedList(){
-    Node<T>* now=root;
-    while (now!= nullptr){
-        Node<T>* n=now->next;
-        delete now;
-        now=n;
+template <typename T, typename Alloc>
+LinkedList<T, Alloc>::~LinkedList(){
+    Clear();
+}
+// With an allocator that has release(), only the elements' destructors run
+// per node (none at all for trivially destructible T).
+template <typename T, typename Alloc>
+void LinkedList<T, Alloc>::Clear(){
+    if constexpr (HasRelease<Alloc>::value) {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            Node<T>* now=root;
+            while (now!=nullptr){
+                Node<T>* n=now->next;
+                now->~Node<T>();
+                now=n;
+            }
+        }
+        Alloc::release();
+    } else {
+        Node<T>* now=root;
+        while (now!= nullptr){
+            Node<T>* n=now->next;
+            freeNode(now);
+            now=n;
+        }
     }
+    root=nullptr;
+    tail=nullptr;
+    size=0;
+    cursor=nullptr;
+    cursorIndex=0;
 }
-template <typename T>
-void LinkedList<T>::Append(const T& value){
-    auto* NewNode=new Node<T>(value);
-    if (root==nullptr){
+template <typename T, typename Alloc>
+void LinkedList<T, Alloc>::Append(const T& value){
+    auto* NewNode=makeNode(value);
+    if (tail==nullptr){
         root=NewNode;
     }
     else{
-        Node<T>* now=root;
-        while(now->next!= nullptr){
-            now=now->next;
-        }
-        now->next=NewNode;
-        NewNode->previous=now;
+        tail->next=NewNode;
+        NewNode->previous=tail;
     }
+    tail=NewNode;
     size+=1;
 };
-template <typename T>
-void LinkedList<T>::Prepend(const T& value){
-    auto* NewNode=new Node<T>(value);
+template <typename T, typename Alloc>
+void LinkedList<T, Alloc>::Prepend(const T& value){
+    auto* NewNode=makeNode(value);
     if (root!=nullptr) {
         NewNode->next = root;
         root->previous = NewNode;
     }
+    else {
+        tail = NewNode;
+    }
     root=NewNode;
     size+=1;
+    if (cursor!=nullptr) cursorIndex+=1;
 }
-template <typename T>
-void LinkedList<T>::Insert(const T &value, int index) {
-    if (index>size or index<0){
+template <typename T, typename Alloc>
+void LinkedList<T, Alloc>::Insert(const T &value, std::size_t index) {
+    if (index>size){
         throw std::out_of_range("Index out of range");
     }
     if (index==0){
@@ -140,80 +235,74 @@ void LinkedList<T>::Insert(const T &value, int index) {
         Append(value);
         return;
     }
-    auto* NewNode=new Node<T>(value);
-    int index_now=0;
-    Node<T>* now=root;
-    while(index_now!=(index-1)){
-        now=now->next;
-        index_now+=1;
-    }
+    Node<T>* now=nodeAt(index-1);
+    auto* NewNode=makeNode(value);
     Node<T>* n=now->next;
     now->next=NewNode;
     NewNode->previous=now;
     NewNode->next=n;
     n->previous=NewNode;
     size+=1;
+    if (cursorIndex>=index) cursorIndex+=1;
 }
-template <typename T>
-T LinkedList<T>::Get(int index) const{
-    if (index<0 or index>=size){
+template <typename T, typename Alloc>
+T LinkedList<T, Alloc>::Get(std::size_t index) const{
+    if (index>=size){
         throw std::out_of_range("Index out of range");
     }
     else{
-        int index_now=0;
-        Node<T>* n=root;
-        while (index_now!= index){
-            n=n->next;
-            index_now+=1;
-        }
-        return n->key;
+        return nodeAt(index)->key;
     }
 }
-template <typename T>
-void LinkedList<T>::Remove(int index){
-    if (index<0 or index>=size){
+template <typename T, typename Alloc>
+void LinkedList<T, Alloc>::CopyTo(std::size_t start, std::size_t count, T* out) const {
+    if (start > size || count > size - start) {
+        throw std::out_of_range("Index out of range");
+    }
+    if (count == 0) return;
+    Node<T>* n = nodeAt(start);
+    for (std::size_t i = 0; i < count; ++i, n = n->next) out[i] = n->key;
+}
+template <typename T, typename Alloc>
+void LinkedList<T, Alloc>::Remove(std::size_t index){
+    if (index>=size){
         throw std::out_of_range("Index out of range");
     }
     else{
         if (size == 0) {
             throw std::underflow_error("List is empty");
         }
-        int index_now=0;
-        Node<T>* n=root;
-        if (index==0){
-            root=n->next;
-            if (root!=nullptr){
-                root->previous=nullptr;
-            }
-            delete n;
-            size-=1;
-            return;
-        }
-        while (index_now!=index){
-            n=n->next;
-            index_now+=1;
-        }
+        Node<T>* n=nodeAt(index);
         if (n->next != nullptr) {
             n->next->previous = n->previous;
         }
+        else {
+            tail = n->previous;
+        }
         if (n->previous != nullptr) {
             n->previous->next = n->next;
         }
+        else {
+            root = n->next;
+        }
+        // The cursor sat on n; step it to a neighbour that keeps its index.
+        cursor = n->next != nullptr ? n->next : n->previous;
+        if (n->next == nullptr && cursor != nullptr) cursorIndex -= 1;
 
-        delete n;
+        freeNode(n);
         size--;
     }
 }
-template <typename T>
-int LinkedList<T>::GetLength() const {
+template <typename T, typename Alloc>
+std::size_t LinkedList<T, Alloc>::GetLength() const {
     return size;
 }
-template <typename T>
-T LinkedList<T>::GetFirst() const{
+template <typename T, typename Alloc>
+T LinkedList<T, Alloc>::GetFirst() const{
     return Get(0);
 }
-template <typename T>
-T LinkedList<T>::GetLast() const{
+template <typename T, typename Alloc>
+T LinkedList<T, Alloc>::GetLast() const{
     return Get(size-1);
 }
 #endif
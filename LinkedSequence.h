@@ -3,126 +3,138 @@
 
 #include "LinkedList.h"
 #include "Sequence.h"
+#include "DynamicArray.h"
 
-template <typename T>
+// List is LinkedList<T> or another list with the same interface, such as
+// UnrolledLinkedList<T>.
+template <typename T, typename List = LinkedList<T>>
 class LinkedSequence : public Sequence<T> {
 protected:
-    LinkedList<T>* list;
-    virtual LinkedSequence<T>* Instance()=0;
-    virtual LinkedSequence<T>* Clone()=0;
+    List* list;
+    virtual LinkedSequence* Instance()=0;
+    virtual LinkedSequence* Clone()=0;
 public:
     LinkedSequence();
-    LinkedSequence(const LinkedSequence<T>& other);
-    LinkedSequence(T* items, int count);
-    LinkedSequence(const LinkedList<T>& otherList);
-    LinkedSequence(LinkedList<T>* otherList);
+    LinkedSequence(const LinkedSequence& other);
+    LinkedSequence(T* items, std::size_t count);
+    LinkedSequence(const List& otherList);
+    LinkedSequence(List* otherList);
     ~LinkedSequence();
-    T Get(int index) const override;
+    T Get(std::size_t index) const override;
     T GetFirst() const override;
     T GetLast() const override;
-    int GetLength() const override;
+    std::size_t GetLength() const override;
     Sequence<T>* Append(const T& item) override;
     Sequence<T>* Prepend(const T& item) override;
-    Sequence<T>* Insert(const T& item, int index) override;
-    Sequence<T>* Remove(int index);
-    Sequence<T>* GetSubsequence(int startIndex, int endIndex) override;
+    Sequence<T>* Insert(const T& item, std::size_t index) override;
+    Sequence<T>* Remove(std::size_t index);
+    Sequence<T>* GetSubsequence(std::size_t startIndex, std::size_t endIndex) override;
     Sequence<T>* Concat(Sequence<T>* other) override;
+    void CopyRange(std::size_t start, std::size_t count, T* out) const override;
 };
-template <typename T>
-LinkedSequence<T>::LinkedSequence() {
-    list = new LinkedList<T>();
+template <typename T, typename List>
+LinkedSequence<T, List>::LinkedSequence() {
+    list = new List();
 }
-template <typename T>
-LinkedSequence<T>::LinkedSequence(const LinkedSequence<T>& other) {
-    list = new LinkedList<T>(*other.list);
+template <typename T, typename List>
+LinkedSequence<T, List>::LinkedSequence(const LinkedSequence& other) {
+    list = new List(*other.list);
 }
-template <typename T>
-LinkedSequence<T>::LinkedSequence(T* items, int count) {
-    list = new LinkedList<T>(items, count);
+template <typename T, typename List>
+LinkedSequence<T, List>::LinkedSequence(T* items, std::size_t count) {
+    list = new List(items, count);
 }
 
-template <typename T>
-LinkedSequence<T>::LinkedSequence(const LinkedList<T>& otherList) {
-    list = new LinkedList<T>(otherList);
+template <typename T, typename List>
+LinkedSequence<T, List>::LinkedSequence(const List& otherList) {
+    list = new List(otherList);
 }
-template <typename T>
-LinkedSequence<T>::LinkedSequence(LinkedList<T>* otherList){
-    list=new LinkedList<T>(*otherList);
+template <typename T, typename List>
+LinkedSequence<T, List>::LinkedSequence(List* otherList){
+    list=new List(*otherList);
 }
-template <typename T>
-LinkedSequence<T>::~LinkedSequence() {
+template <typename T, typename List>
+LinkedSequence<T, List>::~LinkedSequence() {
     delete list;
 }
 
-template <typename T>
-T LinkedSequence<T>::Get(int index) const {
+template <typename T, typename List>
+T LinkedSequence<T, List>::Get(std::size_t index) const {
     if (list->GetLength() == 0)
         throw std::out_of_range("Sequence is empty");
     return list->Get(index);
 }
 
-template <typename T>
-T LinkedSequence<T>::GetFirst() const {
+template <typename T, typename List>
+T LinkedSequence<T, List>::GetFirst() const {
     if (list->GetLength() == 0)
         throw std::out_of_range("Sequence is empty");
     return list->GetFirst();
 }
 
-template <typename T>
-T LinkedSequence<T>::GetLast() const {
+template <typename T, typename List>
+T LinkedSequence<T, List>::GetLast() const {
     if (list->GetLength() == 0)
         throw std::out_of_range("Sequence is empty");
     return list->GetLast();
 }
 
-template <typename T>
-int LinkedSequence<T>::GetLength() const {
+template <typename T, typename List>
+std::size_t LinkedSequence<T, List>::GetLength() const {
     return list->GetLength();
 }
 
-template <typename T>
-Sequence<T>* LinkedSequence<T>::Append(const T& item) {
-    LinkedSequence<T>* instance=Instance();
+template <typename T, typename List>
+Sequence<T>* LinkedSequence<T, List>::Append(const T& item) {
+    LinkedSequence* instance=Instance();
     instance->list->Append(item);
     return instance;
 }
 
-template <typename T>
-Sequence<T>* LinkedSequence<T>::Prepend(const T& item) {
-    LinkedSequence<T>* instance=Instance();
+template <typename T, typename List>
+Sequence<T>* LinkedSequence<T, List>::Prepend(const T& item) {
+    LinkedSequence* instance=Instance();
     instance->list->Prepend(item);
     return instance;
 }
 
-template <typename T>
-Sequence<T>* LinkedSequence<T>::Insert(const T& item, int index) {
-    LinkedSequence<T>* instance=Instance();
+template <typename T, typename List>
+Sequence<T>* LinkedSequence<T, List>::Insert(const T& item, std::size_t index) {
+    LinkedSequence* instance=Instance();
     instance->list->Insert(item, index);
     return instance;
 }
-template <typename T>
-Sequence<T>* LinkedSequence<T>::Remove(int index) {
-    LinkedSequence<T>* instance=Instance();
+template <typename T, typename List>
+Sequence<T>* LinkedSequence<T, List>::Remove(std::size_t index) {
+    LinkedSequence* instance=Instance();
     instance->list->Remove(index);
     return instance;
 }
-template <typename T>
-Sequence<T>* LinkedSequence<T>::GetSubsequence(int startIndex, int endIndex) {
-    LinkedList<T>* sub = list->GetSublist(startIndex, endIndex);
-    LinkedSequence<T>* instance=Clone();
+template <typename T, typename List>
+Sequence<T>* LinkedSequence<T, List>::GetSubsequence(std::size_t startIndex, std::size_t endIndex) {
+    List* sub = list->GetSublist(startIndex, endIndex);
+    LinkedSequence* instance=Clone();
     delete instance->list;
     instance->list = sub;
     return instance;
 }
 
-template <typename T>
-Sequence<T>* LinkedSequence<T>::Concat(Sequence<T>* other) {
-    LinkedSequence<T>* instance=Clone();
-    for (int i=0;i<other->GetLength();i++){
-        instance->list->Append(other->Get(i));
+template <typename T, typename List>
+Sequence<T>* LinkedSequence<T, List>::Concat(Sequence<T>* other) {
+    std::size_t OtherSize=other->GetLength();
+    DynamicArray<T> items(OtherSize);
+    if (OtherSize) other->CopyRange(0, OtherSize, &items.Get(0));
+    LinkedSequence* instance=Clone();
+    for (std::size_t i=0;i<OtherSize;i++){
+        instance->list->Append(items.Get(i));
     }
     return instance;
 }
 
+template <typename T, typename List>
+void LinkedSequence<T, List>::CopyRange(std::size_t start, std::size_t count, T* out) const {
+    list->CopyTo(start, count, out);
+}
+
 
 #endif
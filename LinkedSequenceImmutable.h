@@ -3,19 +3,23 @@
 
 #include "LinkedSequence.h"
 #include "Sequence.h"
+#include "UnrolledLinkedList.h"
 #include <stdexcept>
 
-template <typename T>
-class LinkedSequenceImmutable : public LinkedSequence<T> {
+template <typename T, typename List = LinkedList<T>>
+class LinkedSequenceImmutable : public LinkedSequence<T, List> {
 private:
-    LinkedSequence<T>* Instance() override {
+    LinkedSequence<T, List>* Instance() override {
         return Clone();
     }
-    LinkedSequence<T>* Clone() override{
-        return new LinkedSequenceImmutable<T>(*this);
+    LinkedSequence<T, List>* Clone() override{
+        return new LinkedSequenceImmutable(*this);
     }
 public:
-    using LinkedSequence<T>::LinkedSequence;
+    using LinkedSequence<T, List>::LinkedSequence;
 };
 
+template <typename T>
+using UnrolledLinkedSequenceImmutable = LinkedSequenceImmutable<T, UnrolledLinkedList<T>>;
+
 #endif
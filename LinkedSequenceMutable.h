@@ -3,17 +3,22 @@
 
 #include "LinkedSequence.h"
 #include "Sequence.h"
+#include "UnrolledLinkedList.h"
 #include <stdexcept>
-template <typename T>
-class LinkedSequenceMutable : public LinkedSequence<T> {
+template <typename T, typename List = LinkedList<T>>
+class LinkedSequenceMutable : public LinkedSequence<T, List> {
 private:
-    LinkedSequence<T>* Instance() override {
+    LinkedSequence<T, List>* Instance() override {
         return this;
     }
-    LinkedSequence<T>* Clone() override{
-    return new LinkedSequenceMutable<T>(*this);
+    LinkedSequence<T, List>* Clone() override{
+    return new LinkedSequenceMutable(*this);
     }
 public:
-    using LinkedSequence<T>::LinkedSequence;
+    using LinkedSequence<T, List>::LinkedSequence;
 };
+
+// Same sequence over an unrolled list: several elements per node.
+template <typename T>
+using UnrolledLinkedSequenceMutable = LinkedSequenceMutable<T, UnrolledLinkedList<T>>;
 #endif
@@ -0,0 +1,211 @@
+#ifndef MPMCQUEUE_H
+#define MPMCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "PoolAllocator.h"
+
+// Bounded lock-free multi-producer/multi-consumer queue (Vyukov's
+// sequence-numbered ring). Each cell carries a sequence number telling
+// producers and consumers whose turn it is: a producer claims position pos
+// when the cell's sequence equals pos, a consumer when it equals pos + 1.
+// A push or pop is one CAS on the shared position plus a release store on
+// the cell; no lock is taken, and TryPush/TryPop return false at once when
+// the queue is full or empty.
+//
+// Capacity is rounded up to a power of two and fixed. T's move constructor
+// and move assignment must not throw, so a claimed cell is always completed.
+template <typename T>
+class MPMCQueue {
+    static_assert(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+                  "MPMCQueue: T must be nothrow movable");
+
+public:
+    explicit MPMCQueue(std::size_t capacity);
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+    ~MPMCQueue();
+
+    // Return false instead of waiting when the queue is full / empty.
+    bool TryPush(const T& item);
+    bool TryPush(T&& item);
+    bool TryPop(T& out);
+
+    std::size_t GetCapacity() const { return mask + 1; }
+    // Exact only while no other thread is pushing or popping.
+    std::size_t GetSize() const;
+
+private:
+    static constexpr std::size_t CacheLine = 64;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+        T* item() { return reinterpret_cast<T*>(storage); }
+    };
+
+    Cell* cells;
+    std::size_t mask;
+    // Producers and consumers each hammer one position; keep them on
+    // separate cache lines.
+    alignas(CacheLine) std::atomic<std::size_t> enqueuePos;
+    alignas(CacheLine) std::atomic<std::size_t> dequeuePos;
+
+    bool push(T&& item);
+};
+
+template <typename T>
+MPMCQueue<T>::MPMCQueue(std::size_t capacity) : cells(nullptr), mask(0), enqueuePos(0), dequeuePos(0) {
+    if (capacity == 0) throw std::invalid_argument("MPMCQueue: capacity must be positive");
+    if (capacity > PTRDIFF_MAX / sizeof(Cell)) throw std::length_error("MPMCQueue: capacity too large");
+    std::size_t rounded = 2;
+    while (rounded < capacity) rounded *= 2;
+    cells = static_cast<Cell*>(HeapAllocator().allocate(rounded * sizeof(Cell), alignof(Cell)));
+    for (std::size_t i = 0; i < rounded; ++i) ::new (static_cast<void*>(&cells[i].sequence)) std::atomic<std::size_t>(i);
+    mask = rounded - 1;
+}
+
+template <typename T>
+MPMCQueue<T>::~MPMCQueue() {
+    std::size_t end = enqueuePos.load(std::memory_order_relaxed);
+    for (std::size_t pos = dequeuePos.load(std::memory_order_relaxed); pos != end; ++pos)
+        cells[pos & mask].item()->~T();
+    HeapAllocator().deallocate(cells, (mask + 1) * sizeof(Cell), alignof(Cell));
+}
+
+template <typename T>
+bool MPMCQueue<T>::push(T&& item) {
+    Cell* cell;
+    std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &cells[pos & mask];
+        std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+        std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    ::new (static_cast<void*>(cell->storage)) T(std::move(item));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+// The copy is made before a cell is claimed, so a throwing copy leaves the
+// queue untouched.
+template <typename T>
+bool MPMCQueue<T>::TryPush(const T& item) {
+    T copy(item);
+    return push(std::move(copy));
+}
+
+template <typename T>
+bool MPMCQueue<T>::TryPush(T&& item) {
+    return push(std::move(item));
+}
+
+template <typename T>
+bool MPMCQueue<T>::TryPop(T& out) {
+    Cell* cell;
+    std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &cells[pos & mask];
+        std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+        std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    T* item = cell->item();
+    out = std::move(*item);
+    item->~T();
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+std::size_t MPMCQueue<T>::GetSize() const {
+    std::size_t tail = dequeuePos.load(std::memory_order_acquire);
+    std::size_t head = enqueuePos.load(std::memory_order_acquire);
+    return head > tail ? head - tail : 0;
+}
+
+// MPMCQueue whose Push and Pop wait (spinning, then yielding) instead of
+// failing. Close() lets consumers drain the queue and stop: once it has been
+// called, Pop returns false as soon as the queue is empty. Call it after
+// every producer has finished pushing.
+template <typename T>
+class BlockingMPMCQueue {
+public:
+    explicit BlockingMPMCQueue(std::size_t capacity) : queue(capacity), closed(false) {}
+
+    // Returns false, without pushing, once the queue is closed.
+    bool Push(const T& item);
+    bool Push(T&& item);
+    // Returns false once the queue is closed and empty.
+    bool Pop(T& out);
+
+    bool TryPush(const T& item) { return queue.TryPush(item); }
+    bool TryPush(T&& item) { return queue.TryPush(std::move(item)); }
+    bool TryPop(T& out) { return queue.TryPop(out); }
+
+    void Close() { closed.store(true, std::memory_order_release); }
+    bool IsClosed() const { return closed.load(std::memory_order_acquire); }
+
+    std::size_t GetCapacity() const { return queue.GetCapacity(); }
+    std::size_t GetSize() const { return queue.GetSize(); }
+
+private:
+    static constexpr unsigned SpinLimit = 64;
+
+    MPMCQueue<T> queue;
+    std::atomic<bool> closed;
+
+    static void backoff(unsigned& spins) {
+        if (spins < SpinLimit) ++spins;
+        else std::this_thread::yield();
+    }
+};
+
+template <typename T>
+bool BlockingMPMCQueue<T>::Push(const T& item) {
+    T copy(item);
+    return Push(std::move(copy));
+}
+
+// TryPush leaves item alone when it fails, so it can be retried.
+template <typename T>
+bool BlockingMPMCQueue<T>::Push(T&& item) {
+    unsigned spins = 0;
+    while (!IsClosed()) {
+        if (queue.TryPush(std::move(item))) return true;
+        backoff(spins);
+    }
+    return false;
+}
+
+template <typename T>
+bool BlockingMPMCQueue<T>::Pop(T& out) {
+    unsigned spins = 0;
+    for (;;) {
+        if (queue.TryPop(out)) return true;
+        if (IsClosed()) return queue.TryPop(out);
+        backoff(spins);
+    }
+}
+
+#endif
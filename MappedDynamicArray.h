@@ -0,0 +1,327 @@
+#ifndef MAPPEDDYNAMICARRAY_H
+#define MAPPEDDYNAMICARRAY_H
+
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <new>
+#include <utility>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// DynamicArray for trivially copyable T whose elements live in a
+// memory-mapped file. Growth extends the (sparse) file with ftruncate and
+// remaps it (mremap on Linux, a fresh mapping elsewhere), so elements are
+// never copied and the OS can page cold parts of a huge memoised prefix out
+// to the file instead of swap.
+//
+// Opened with a path, the array is persistent: the file starts with a
+// small header recording the element size and count, and reopening the same
+// path later resumes from the stored elements without recomputing them.
+// Default-constructed (and copied) arrays use an unlinked temporary file.
+//
+// Same interface as DynamicArray. POSIX only. Errors from the system calls
+// are reported as std::runtime_error.
+template <typename T>
+class MappedDynamicArray {
+    static_assert(std::is_trivially_copyable<T>::value, "MappedDynamicArray: T must be trivially copyable");
+    static_assert(alignof(T) <= 64, "MappedDynamicArray: T is over-aligned");
+
+public:
+    MappedDynamicArray();
+    explicit MappedDynamicArray(const std::string& path);
+    MappedDynamicArray(T* items, std::size_t count);
+    MappedDynamicArray(const MappedDynamicArray& other);
+    MappedDynamicArray(MappedDynamicArray&& other) noexcept;
+    MappedDynamicArray& operator=(const MappedDynamicArray& other);
+    MappedDynamicArray& operator=(MappedDynamicArray&& other) noexcept;
+    ~MappedDynamicArray();
+
+    const T& Get(std::size_t index) const;
+    T& Get(std::size_t index);
+    std::size_t GetSize() const { return base ? header()->size : 0; }
+    void Set(std::size_t index, const T& value);
+    // Assigns elements [start, start + count) to out[0..count).
+    void CopyTo(std::size_t start, std::size_t count, T* out) const;
+
+    void Reserve(std::size_t newCapacity);
+    void Resize(std::size_t NewSize);
+    void Append(const T& value);
+    template <typename... Args>
+    T& Emplace(Args&&... args);
+
+    // Writes dirty pages back to the file and waits for completion.
+    void Flush();
+
+    bool operator==(const MappedDynamicArray& other) const {
+        std::size_t n = GetSize();
+        if (n != other.GetSize()) return false;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (data()[i] != other.data()[i]) return false;
+        }
+        return true;
+    }
+    bool operator!=(const MappedDynamicArray& other) const {
+        return !(*this == other);
+    }
+
+    static constexpr std::size_t MaxSize() { return (PTRDIFF_MAX - DataOffset) / sizeof(T); }
+
+private:
+    struct Header {
+        std::uint64_t magic;
+        std::uint64_t elementSize;
+        std::uint64_t size;
+    };
+    static constexpr std::uint64_t Magic = 0x5952524141504d4dULL;
+    static constexpr std::size_t DataOffset = 64;
+
+    int fd;
+    char* base;
+    std::size_t mappedBytes;
+    std::size_t capacity;
+
+    Header* header() const { return reinterpret_cast<Header*>(base); }
+    T* data() const { return reinterpret_cast<T*>(base + DataOffset); }
+
+    static void fail(const char* what);
+    void openTemporary();
+    void mapFile(std::size_t bytes);
+    void ensureCapacity(std::size_t minCapacity);
+    void close();
+};
+
+template <typename T>
+void MappedDynamicArray<T>::fail(const char* what) {
+    throw std::runtime_error(std::string("MappedDynamicArray: ") + what + ": " + std::strerror(errno));
+}
+
+template <typename T>
+MappedDynamicArray<T>::MappedDynamicArray()
+    : fd(-1), base(nullptr), mappedBytes(0), capacity(0)
+{
+    openTemporary();
+}
+
+template <typename T>
+MappedDynamicArray<T>::MappedDynamicArray(const std::string& path)
+    : fd(-1), base(nullptr), mappedBytes(0), capacity(0)
+{
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) fail("open");
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        fail("fstat");
+    }
+    std::size_t bytes = static_cast<std::size_t>(st.st_size);
+    try {
+        if (bytes == 0) {
+            mapFile(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)));
+            header()->magic = Magic;
+            header()->elementSize = sizeof(T);
+            header()->size = 0;
+            return;
+        }
+        if (bytes < DataOffset) throw std::runtime_error("MappedDynamicArray: " + path + " is not an array file");
+        mapFile(bytes);
+        if (header()->magic != Magic || header()->elementSize != sizeof(T) || header()->size > capacity)
+            throw std::runtime_error("MappedDynamicArray: " + path + " has an incompatible header");
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+template <typename T>
+MappedDynamicArray<T>::MappedDynamicArray(T* items, std::size_t count)
+    : MappedDynamicArray()
+{
+    Reserve(count);
+    if (count) std::memcpy(data(), items, count * sizeof(T));
+    header()->size = count;
+}
+
+template <typename T>
+MappedDynamicArray<T>::MappedDynamicArray(const MappedDynamicArray& other)
+    : MappedDynamicArray(other.base ? other.data() : nullptr, other.GetSize())
+{ }
+
+template <typename T>
+MappedDynamicArray<T>::MappedDynamicArray(MappedDynamicArray&& other) noexcept
+    : fd(other.fd), base(other.base), mappedBytes(other.mappedBytes), capacity(other.capacity)
+{
+    other.fd = -1;
+    other.base = nullptr;
+    other.mappedBytes = 0;
+    other.capacity = 0;
+}
+
+template <typename T>
+MappedDynamicArray<T>& MappedDynamicArray<T>::operator=(const MappedDynamicArray& other) {
+    if (this == &other) return *this;
+    if (!base) openTemporary();
+    std::size_t n = other.GetSize();
+    Reserve(n);
+    if (n) std::memcpy(data(), other.data(), n * sizeof(T));
+    header()->size = n;
+    return *this;
+}
+
+template <typename T>
+MappedDynamicArray<T>& MappedDynamicArray<T>::operator=(MappedDynamicArray&& other) noexcept {
+    if (this == &other) return *this;
+    close();
+    std::swap(fd, other.fd);
+    std::swap(base, other.base);
+    std::swap(mappedBytes, other.mappedBytes);
+    std::swap(capacity, other.capacity);
+    return *this;
+}
+
+template <typename T>
+MappedDynamicArray<T>::~MappedDynamicArray() {
+    close();
+}
+
+template <typename T>
+void MappedDynamicArray<T>::close() {
+    if (base) ::munmap(base, mappedBytes);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    base = nullptr;
+    mappedBytes = 0;
+    capacity = 0;
+}
+
+// The file is unlinked straight away, so it disappears with the descriptor.
+template <typename T>
+void MappedDynamicArray<T>::openTemporary() {
+    const char* dir = std::getenv("TMPDIR");
+    std::string path = std::string(dir && *dir ? dir : "/tmp") + "/mapped-array-XXXXXX";
+    fd = ::mkstemp(&path[0]);
+    if (fd < 0) fail("mkstemp");
+    ::unlink(path.c_str());
+    try {
+        mapFile(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)));
+    } catch (...) {
+        close();
+        throw;
+    }
+    header()->magic = Magic;
+    header()->elementSize = sizeof(T);
+    header()->size = 0;
+}
+
+// Sizes the file to bytes and (re)maps all of it.
+template <typename T>
+void MappedDynamicArray<T>::mapFile(std::size_t bytes) {
+    struct stat st;
+    if (::fstat(fd, &st) != 0) fail("fstat");
+    if (static_cast<std::size_t>(st.st_size) < bytes && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0) fail("ftruncate");
+    void* p;
+    if (!base) {
+        p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    } else {
+#ifdef __linux__
+        p = ::mremap(base, mappedBytes, bytes, MREMAP_MAYMOVE);
+#else
+        p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) ::munmap(base, mappedBytes);
+#endif
+    }
+    if (p == MAP_FAILED) fail("mmap");
+    base = static_cast<char*>(p);
+    mappedBytes = bytes;
+    capacity = (bytes - DataOffset) / sizeof(T);
+}
+
+template <typename T>
+void MappedDynamicArray<T>::ensureCapacity(std::size_t minCapacity) {
+    if (capacity >= minCapacity) return;
+    if (minCapacity > MaxSize()) throw std::length_error("MappedDynamicArray: requested size exceeds MaxSize()");
+    std::size_t doubled = capacity > MaxSize() / 2 ? MaxSize() : capacity * 2;
+    std::size_t newCap = std::max(doubled, minCapacity);
+    std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t bytes = DataOffset + newCap * sizeof(T);
+    mapFile((bytes + page - 1) / page * page);
+}
+
+template <typename T>
+const T& MappedDynamicArray<T>::Get(std::size_t index) const {
+    if (index >= GetSize()) {
+        throw std::out_of_range("MappedDynamicArray::Get: index out of range");
+    }
+    return data()[index];
+}
+
+template <typename T>
+T& MappedDynamicArray<T>::Get(std::size_t index) {
+    if (index >= GetSize()) {
+        throw std::out_of_range("MappedDynamicArray::Get: index out of range");
+    }
+    return data()[index];
+}
+
+template <typename T>
+void MappedDynamicArray<T>::Set(std::size_t index, const T& value) {
+    if (index >= GetSize()) {
+        throw std::out_of_range("MappedDynamicArray::Set: index out of range");
+    }
+    data()[index] = value;
+}
+
+template <typename T>
+void MappedDynamicArray<T>::CopyTo(std::size_t start, std::size_t count, T* out) const {
+    std::size_t n = GetSize();
+    if (start > n || count > n - start) {
+        throw std::out_of_range("MappedDynamicArray::CopyTo: range out of bounds");
+    }
+    if (count) std::memmove(out, data() + start, count * sizeof(T));
+}
+
+template <typename T>
+void MappedDynamicArray<T>::Reserve(std::size_t newCapacity) {
+    if (!base) openTemporary();
+    ensureCapacity(newCapacity);
+}
+
+template <typename T>
+void MappedDynamicArray<T>::Resize(std::size_t NewSize) {
+    Reserve(NewSize);
+    for (std::size_t i = header()->size; i < NewSize; ++i) ::new (static_cast<void*>(data() + i)) T();
+    header()->size = NewSize;
+}
+
+// value may live in the mapping, which growth can move, so it is copied first.
+template <typename T>
+void MappedDynamicArray<T>::Append(const T& value) {
+    T copy(value);
+    Reserve(GetSize() + 1);
+    data()[header()->size] = copy;
+    ++header()->size;
+}
+
+template <typename T>
+template <typename... Args>
+T& MappedDynamicArray<T>::Emplace(Args&&... args) {
+    T value(std::forward<Args>(args)...);
+    Append(value);
+    return data()[header()->size - 1];
+}
+
+template <typename T>
+void MappedDynamicArray<T>::Flush() {
+    if (base && ::msync(base, mappedBytes, MS_SYNC) != 0) fail("msync");
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "ArraySequence.h"
 #include <stdexcept>
+#include <utility>
 
 template <typename T>
 class MutableArraySequence : public ArraySequence<T> {
@@ -13,6 +14,9 @@ private:
     ArraySequence<T>* Clone() override{
         return new MutableArraySequence<T>(*this);
     }
+    ArraySequence<T>* WithArray(DynamicArray<T>&& arr) override {
+        return new MutableArraySequence<T>(std::move(arr));
+    }
 public:
     using ArraySequence<T>::ArraySequence;
 
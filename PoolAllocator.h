@@ -0,0 +1,400 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <mutex>
+#include <type_traits>
+#include <cstdint>
+#include <utility>
+
+// Byte allocators used by AllocateShared/MakeShared and by the containers
+// (DynamicArray, LinkedList). An allocator is any copyable class with
+//     void* allocate(std::size_t bytes, std::size_t align);
+//     void deallocate(void* p, std::size_t bytes, std::size_t align);
+// where deallocate receives the same size and alignment that were requested.
+// It may also provide
+//     void* reallocate(void* p, std::size_t oldBytes, std::size_t newBytes, std::size_t align);
+// which DynamicArray uses to grow arrays of trivially copyable elements;
+// the contents are carried over bytewise.
+
+
+// Plain global operator new / operator delete.
+struct HeapAllocator {
+    void* allocate(std::size_t bytes, std::size_t align) {
+        if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(bytes, std::align_val_t(align));
+        return ::operator new(bytes);
+    }
+    void deallocate(void* p, std::size_t bytes, std::size_t align) {
+        if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(p, bytes, std::align_val_t(align));
+        else ::operator delete(p, bytes);
+    }
+};
+
+
+// malloc/realloc/free; the default for DynamicArray, where realloc lets a
+// growing array of trivially copyable elements be extended in place.
+// Over-aligned requests go through HeapAllocator.
+struct MallocAllocator {
+    void* allocate(std::size_t bytes, std::size_t align) {
+        if (align > alignof(std::max_align_t)) return HeapAllocator().allocate(bytes, align);
+        void* p = std::malloc(bytes ? bytes : 1);
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+    void deallocate(void* p, std::size_t bytes, std::size_t align) {
+        if (align > alignof(std::max_align_t)) HeapAllocator().deallocate(p, bytes, align);
+        else std::free(p);
+    }
+    void* reallocate(void* p, std::size_t oldBytes, std::size_t newBytes, std::size_t align) {
+        if (align > alignof(std::max_align_t)) {
+            void* q = allocate(newBytes, align);
+            std::memcpy(q, p, oldBytes < newBytes ? oldBytes : newBytes);
+            deallocate(p, oldBytes, align);
+            return q;
+        }
+        void* q = std::realloc(p, newBytes ? newBytes : 1);
+        if (!q) throw std::bad_alloc();
+        return q;
+    }
+};
+
+
+template<class Alloc, class = void>
+struct HasReallocate : std::false_type {};
+
+template<class Alloc>
+struct HasReallocate<Alloc, decltype(void(std::declval<Alloc&>().reallocate((void*)0, std::size_t(), std::size_t(), std::size_t())))>
+    : std::true_type {};
+
+// An allocator with release() frees everything it handed out in one call;
+// containers then skip the per-element deallocate when they are cleared.
+template<class Alloc, class = void>
+struct HasRelease : std::false_type {};
+
+template<class Alloc>
+struct HasRelease<Alloc, decltype(void(std::declval<Alloc&>().release()))>
+    : std::true_type {};
+
+
+// Bump allocator: carves requests out of large chunks and ignores
+// individual deallocations; everything is returned at once by release() or
+// the destructor. Meant for caches whose lifetime is a whole pipeline.
+// Not thread-safe. Use it through ArenaAllocator.
+class Arena {
+public:
+    static constexpr std::size_t DefaultChunkSize = 64 * 1024;
+
+    explicit Arena(std::size_t chunkSize = DefaultChunkSize)
+        : chunkSize_(chunkSize), chunks_(nullptr), cursor_(nullptr), limit_(nullptr), used_(0) {}
+    ~Arena() { release(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t align) {
+        char* p = alignUp(cursor_, align);
+        if (!cursor_ || p + bytes > limit_) {
+            std::size_t need = bytes + align + sizeof(Chunk);
+            addChunk(need > chunkSize_ ? need : chunkSize_);
+            p = alignUp(cursor_, align);
+        }
+        cursor_ = p + bytes;
+        used_ += bytes;
+        return p;
+    }
+
+    // Frees every chunk; all memory handed out by this arena becomes invalid.
+    void release() {
+        while (chunks_) {
+            Chunk* next = chunks_->next;
+            ::operator delete(chunks_);
+            chunks_ = next;
+        }
+        cursor_ = limit_ = nullptr;
+        used_ = 0;
+    }
+
+    std::size_t bytes_used() const { return used_; }
+
+private:
+    struct alignas(std::max_align_t) Chunk { Chunk* next; };
+
+    static char* alignUp(char* p, std::size_t align) {
+        std::uintptr_t v = reinterpret_cast<std::uintptr_t>(p);
+        return reinterpret_cast<char*>((v + align - 1) & ~(std::uintptr_t(align) - 1));
+    }
+
+    void addChunk(std::size_t size) {
+        Chunk* c = static_cast<Chunk*>(::operator new(size));
+        c->next = chunks_;
+        chunks_ = c;
+        cursor_ = reinterpret_cast<char*>(c + 1);
+        limit_ = reinterpret_cast<char*>(c) + size;
+    }
+
+    std::size_t chunkSize_;
+    Chunk* chunks_;
+    char* cursor_;
+    char* limit_;
+    std::size_t used_;
+};
+
+// Allocator handle onto an Arena; copies share the arena.
+class ArenaAllocator {
+public:
+    explicit ArenaAllocator(Arena& arena) : arena_(&arena) {}
+    void* allocate(std::size_t bytes, std::size_t align) { return arena_->allocate(bytes, align); }
+    void deallocate(void*, std::size_t, std::size_t) {}
+
+private:
+    Arena* arena_;
+};
+
+
+// Slab pool owned by a single container (LinkedList's nodes). Blocks of one
+// size are cut from slabs that double from MinSlabBlocks to MaxSlabBlocks
+// blocks, so n nodes cost O(log n) system allocations; freed blocks are
+// reused through a free list. release() and the destructor free every slab
+// at once. A copy starts out empty, so each container gets its own pool.
+// Not thread-safe. Requests of another size, or over-aligned ones, go
+// through HeapAllocator.
+class NodePool {
+public:
+    static constexpr std::size_t MinSlabBlocks = 16;
+    static constexpr std::size_t MaxSlabBlocks = 4096;
+
+    NodePool()
+        : slabs_(nullptr), free_(nullptr), cursor_(nullptr), limit_(nullptr),
+          blockSize_(0), blockAlign_(0), nextSlabBlocks_(MinSlabBlocks), slabCount_(0) {}
+    NodePool(const NodePool&) : NodePool() {}
+    NodePool& operator=(const NodePool&) { return *this; }
+    ~NodePool() { release(); }
+
+    void* allocate(std::size_t bytes, std::size_t align) {
+        if (!pooled(bytes, align)) return HeapAllocator().allocate(bytes, align);
+        if (free_) {
+            FreeBlock* b = free_;
+            free_ = b->next;
+            return b;
+        }
+        if (cursor_ == limit_) addSlab();
+        void* p = cursor_;
+        cursor_ += blockSize_;
+        return p;
+    }
+
+    void deallocate(void* p, std::size_t bytes, std::size_t align) {
+        if (!p) return;
+        if (!pooled(bytes, align)) { HeapAllocator().deallocate(p, bytes, align); return; }
+        FreeBlock* b = static_cast<FreeBlock*>(p);
+        b->next = free_;
+        free_ = b;
+    }
+
+    // Frees every slab; all blocks handed out by this pool become invalid.
+    void release() {
+        while (slabs_) {
+            Slab* next = slabs_->next;
+            ::operator delete(slabs_);
+            slabs_ = next;
+        }
+        free_ = nullptr;
+        cursor_ = limit_ = nullptr;
+        nextSlabBlocks_ = MinSlabBlocks;
+        slabCount_ = 0;
+    }
+
+    std::size_t slab_count() const { return slabCount_; }
+
+private:
+    struct alignas(std::max_align_t) Slab { Slab* next; };
+    struct FreeBlock { FreeBlock* next; };
+
+    // The first request fixes the block size and alignment.
+    bool pooled(std::size_t bytes, std::size_t align) {
+        if (align > alignof(std::max_align_t) || bytes == 0) return false;
+        if (align < alignof(FreeBlock)) align = alignof(FreeBlock);
+        std::size_t size = roundUp(bytes < sizeof(FreeBlock) ? sizeof(FreeBlock) : bytes, align);
+        if (blockSize_ == 0) {
+            blockSize_ = size;
+            blockAlign_ = align;
+        }
+        return size == blockSize_ && align <= blockAlign_;
+    }
+
+    static std::size_t roundUp(std::size_t n, std::size_t align) { return (n + align - 1) / align * align; }
+
+    void addSlab() {
+        Slab* s = static_cast<Slab*>(::operator new(sizeof(Slab) + nextSlabBlocks_ * blockSize_));
+        s->next = slabs_;
+        slabs_ = s;
+        cursor_ = reinterpret_cast<char*>(s + 1);
+        limit_ = cursor_ + nextSlabBlocks_ * blockSize_;
+        if (nextSlabBlocks_ < MaxSlabBlocks) nextSlabBlocks_ *= 2;
+        ++slabCount_;
+    }
+
+    Slab* slabs_;
+    FreeBlock* free_;
+    char* cursor_;
+    char* limit_;
+    std::size_t blockSize_;
+    std::size_t blockAlign_;
+    std::size_t nextSlabBlocks_;
+    std::size_t slabCount_;
+};
+
+
+// Size-class pool for small same-sized objects (control blocks, lazy
+// sequence nodes). Requests are rounded up to a multiple of Granularity and
+// served from per-class free lists. Each thread keeps its own free list per
+// class, so the common allocate/deallocate pair touches no lock; the thread
+// cache exchanges batches with a mutex-protected central list and returns
+// everything to it when the thread exits. Chunks are never given back to the
+// system. Larger or over-aligned requests fall through to HeapAllocator.
+class PoolAllocator {
+public:
+    static constexpr std::size_t Granularity = 16;
+    static constexpr std::size_t MaxBlockSize = 256;
+    static constexpr std::size_t ClassCount = MaxBlockSize / Granularity;
+    static constexpr std::size_t ChunkSize = 64 * 1024;
+    static constexpr std::size_t BatchSize = 32;
+    static constexpr std::size_t CacheLimit = 4 * BatchSize;
+
+    void* allocate(std::size_t bytes, std::size_t align) {
+        if (!pooled(bytes, align)) return HeapAllocator().allocate(bytes, align);
+        std::size_t cls = classOf(bytes);
+        ThreadCache::List& list = threadCache().lists[cls];
+        if (!list.head) refill(list, cls);
+        FreeBlock* b = list.head;
+        list.head = b->next;
+        --list.count;
+        return b;
+    }
+
+    void deallocate(void* p, std::size_t bytes, std::size_t align) {
+        if (!p) return;
+        if (!pooled(bytes, align)) { HeapAllocator().deallocate(p, bytes, align); return; }
+        std::size_t cls = classOf(bytes);
+        ThreadCache::List& list = threadCache().lists[cls];
+        FreeBlock* b = static_cast<FreeBlock*>(p);
+        b->next = list.head;
+        list.head = b;
+        ++list.count;
+        if (list.count > CacheLimit) flush(list, cls, BatchSize);
+    }
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+    struct Chunk { Chunk* next; };
+
+    struct CentralList {
+        std::mutex lock;
+        FreeBlock* head = nullptr;
+    };
+
+    struct Central {
+        CentralList lists[ClassCount];
+        std::mutex chunkLock;
+        Chunk* chunks = nullptr;
+    };
+
+    struct ThreadCache {
+        struct List {
+            FreeBlock* head = nullptr;
+            std::size_t count = 0;
+        };
+        List lists[ClassCount];
+
+        ~ThreadCache() {
+            for (std::size_t cls = 0; cls < ClassCount; ++cls) flush(lists[cls], cls, lists[cls].count);
+        }
+    };
+
+    static bool pooled(std::size_t bytes, std::size_t align) {
+        return bytes != 0 && bytes <= MaxBlockSize && align <= Granularity;
+    }
+    static std::size_t classOf(std::size_t bytes) { return (bytes - 1) / Granularity; }
+    static std::size_t blockSize(std::size_t cls) { return (cls + 1) * Granularity; }
+
+    // Intentionally leaked: blocks may be released by thread caches that are
+    // torn down after static destructors would have run.
+    static Central& central() {
+        static Central* c = new Central();
+        return *c;
+    }
+
+    static ThreadCache& threadCache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    static void refill(ThreadCache::List& list, std::size_t cls) {
+        CentralList& shared = central().lists[cls];
+        {
+            std::lock_guard<std::mutex> guard(shared.lock);
+            while (shared.head && list.count < BatchSize) {
+                FreeBlock* b = shared.head;
+                shared.head = b->next;
+                b->next = list.head;
+                list.head = b;
+                ++list.count;
+            }
+        }
+        if (!list.head) carve(list, cls);
+    }
+
+    // Splits a fresh chunk into blocks of the class size. The thread keeps
+    // one batch; the rest goes to the central list in a single splice, so
+    // the thread cache stays under CacheLimit and later deallocations do not
+    // flush through the lock.
+    static void carve(ThreadCache::List& list, std::size_t cls) {
+        Central& c = central();
+        char* raw = static_cast<char*>(::operator new(ChunkSize));
+        Chunk* chunk = reinterpret_cast<Chunk*>(raw);
+        {
+            std::lock_guard<std::mutex> guard(c.chunkLock);
+            chunk->next = c.chunks;
+            c.chunks = chunk;
+        }
+        std::size_t size = blockSize(cls);
+        std::size_t offset = Granularity;
+        for (std::size_t kept = 0; kept < BatchSize && offset + size <= ChunkSize; ++kept, offset += size) {
+            FreeBlock* b = reinterpret_cast<FreeBlock*>(raw + offset);
+            b->next = list.head;
+            list.head = b;
+            ++list.count;
+        }
+        FreeBlock* first = nullptr;
+        FreeBlock* last = nullptr;
+        for (; offset + size <= ChunkSize; offset += size) {
+            FreeBlock* b = reinterpret_cast<FreeBlock*>(raw + offset);
+            b->next = first;
+            if (!last) last = b;
+            first = b;
+        }
+        if (!first) return;
+        CentralList& shared = c.lists[cls];
+        std::lock_guard<std::mutex> guard(shared.lock);
+        last->next = shared.head;
+        shared.head = first;
+    }
+
+    static void flush(ThreadCache::List& list, std::size_t cls, std::size_t n) {
+        if (n == 0 || !list.head) return;
+        FreeBlock* first = list.head;
+        FreeBlock* last = first;
+        std::size_t moved = 1;
+        while (moved < n && last->next) { last = last->next; ++moved; }
+        list.head = last->next;
+        list.count -= moved;
+
+        CentralList& shared = central().lists[cls];
+        std::lock_guard<std::mutex> guard(shared.lock);
+        last->next = shared.head;
+        shared.head = first;
+    }
+};
@@ -15,7 +15,7 @@ public:
     void Push(const T& item);
     T Pop();
     T Front() const;
-    int GetSize() const;
+    std::size_t GetSize() const;
     void Clear();
 };
 
@@ -56,14 +56,14 @@ T Queue<T>::Front() const {
 }
 
 template <typename T>
-int Queue<T>::GetSize() const {
+std::size_t Queue<T>::GetSize() const {
     return sequence->GetLength();
 }
 
 template <typename T>
 void Queue<T>::Clear() {
-    while (GetSize()!=0) {
-        Pop();
-    }
+    LinkedSequenceMutable<T>* empty = new LinkedSequenceMutable<T>();
+    delete sequence;
+    sequence = empty;
 }
 #endif
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstddef>
 
 #include "DynamicArray.h" 
 #include "SmartPointer.h" 
@@ -29,14 +30,14 @@ private:
         virtual T Read() = 0;
         virtual bool IsEOS() const = 0;
         virtual bool CanSeek() const = 0;
-        virtual int GetPos() const = 0; 
-        virtual void Seek(int index) = 0; 
+        virtual std::size_t GetPos() const = 0; 
+        virtual void Seek(std::size_t index) = 0; 
         virtual void Reset() = 0; 
     };
 
     class ArrayImpl : public IStreamImpl {
         const DynamicArray<T>* array_ptr; 
-        int pos; 
+        std::size_t pos; 
     public:
         ArrayImpl(const DynamicArray<T>* arr) : array_ptr(arr), pos(0) {
             if (!array_ptr) throw std::invalid_argument("ReadOnlyStream: DynamicArray is null");
@@ -49,8 +50,8 @@ private:
             return pos >= array_ptr->GetSize(); 
         }
         bool CanSeek() const override { return true; }
-        int GetPos() const override { return pos; }
-        void Seek(int index) override {
+        std::size_t GetPos() const override { return pos; }
+        void Seek(std::size_t index) override {
             if (index > array_ptr->GetSize()) {
                 throw std::out_of_range("Seek index out of bounds");
             }
@@ -63,7 +64,7 @@ private:
         std::istream* stream;
         UniquePtr<std::istream> ownedStream; 
         Deserializer<T> deserializer;
-        int pos; 
+        std::size_t pos; 
         
     public:
         IoStreamImpl(std::istream* strm, Deserializer<T> deser) 
@@ -82,8 +83,8 @@ private:
         }
         bool IsEOS() const override { return stream->eof(); }
         bool CanSeek() const override { return false; }
-        int GetPos() const override { return pos; }
-        void Seek(int index) override { throw std::logic_error("Seek not supported for generic Input Streams"); }
+        std::size_t GetPos() const override { return pos; }
+        void Seek(std::size_t index) override { throw std::logic_error("Seek not supported for generic Input Streams"); }
         void Reset() override { stream->clear(); pos = 0; }
     };
 
@@ -0,0 +1,213 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <stdexcept>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+#include "PoolAllocator.h"
+
+// Contiguous double-ended buffer: elements occupy a power-of-two array
+// starting at head and wrapping around, so pushes and pops at either end are
+// amortised O(1) and allocate only when the buffer doubles. An empty buffer
+// owns no memory. Backs RingDeque, RingQueue and RingStack.
+template <typename T>
+class RingBuffer {
+public:
+    RingBuffer();
+    RingBuffer(const RingBuffer& other);
+    RingBuffer(RingBuffer&& other) noexcept;
+    RingBuffer& operator=(const RingBuffer& other);
+    RingBuffer& operator=(RingBuffer&& other) noexcept;
+    ~RingBuffer();
+
+    void PushBack(const T& value);
+    void PushFront(const T& value);
+    T PopBack();
+    T PopFront();
+
+    const T& Front() const;
+    const T& Back() const;
+    const T& Get(std::size_t index) const;
+    std::size_t GetSize() const { return size; }
+    std::size_t GetCapacity() const { return capacity; }
+
+    void Reserve(std::size_t newCapacity);
+    void Clear();
+
+    static constexpr std::size_t MaxSize() { return (std::size_t(PTRDIFF_MAX) / sizeof(T) + 1) / 2; }
+
+private:
+    static constexpr std::size_t InitialCapacity = 8;
+
+    T* data;
+    std::size_t capacity;
+    std::size_t head;
+    std::size_t size;
+
+    T* slot(std::size_t i) const { return data + ((head + i) & (capacity - 1)); }
+    void reallocate(std::size_t newCapacity);
+};
+
+template <typename T>
+RingBuffer<T>::RingBuffer() : data(nullptr), capacity(0), head(0), size(0) {}
+
+template <typename T>
+RingBuffer<T>::RingBuffer(const RingBuffer& other) : data(nullptr), capacity(0), head(0), size(0) {
+    Reserve(other.size);
+    try {
+        for (std::size_t i = 0; i < other.size; ++i) PushBack(*other.slot(i));
+    } catch (...) {
+        Clear();
+        HeapAllocator().deallocate(data, capacity * sizeof(T), alignof(T));
+        throw;
+    }
+}
+
+template <typename T>
+RingBuffer<T>::RingBuffer(RingBuffer&& other) noexcept
+    : data(other.data), capacity(other.capacity), head(other.head), size(other.size)
+{
+    other.data = nullptr;
+    other.capacity = 0;
+    other.head = 0;
+    other.size = 0;
+}
+
+template <typename T>
+RingBuffer<T>& RingBuffer<T>::operator=(const RingBuffer& other) {
+    if (this == &other) return *this;
+    RingBuffer copy(other);
+    return *this = std::move(copy);
+}
+
+template <typename T>
+RingBuffer<T>& RingBuffer<T>::operator=(RingBuffer&& other) noexcept {
+    if (this == &other) return *this;
+    Clear();
+    if (data) HeapAllocator().deallocate(data, capacity * sizeof(T), alignof(T));
+    data = other.data;
+    capacity = other.capacity;
+    head = other.head;
+    size = other.size;
+    other.data = nullptr;
+    other.capacity = 0;
+    other.head = 0;
+    other.size = 0;
+    return *this;
+}
+
+template <typename T>
+RingBuffer<T>::~RingBuffer() {
+    Clear();
+    if (data) HeapAllocator().deallocate(data, capacity * sizeof(T), alignof(T));
+}
+
+// Moves the elements, in order, to the start of a new buffer.
+template <typename T>
+void RingBuffer<T>::reallocate(std::size_t newCapacity) {
+    T* newData = static_cast<T*>(HeapAllocator().allocate(newCapacity * sizeof(T), alignof(T)));
+    std::size_t moved = 0;
+    try {
+        for (; moved < size; ++moved)
+            ::new (static_cast<void*>(newData + moved)) T(std::move_if_noexcept(*slot(moved)));
+    } catch (...) {
+        for (std::size_t i = moved; i > 0; --i) newData[i - 1].~T();
+        HeapAllocator().deallocate(newData, newCapacity * sizeof(T), alignof(T));
+        throw;
+    }
+    for (std::size_t i = 0; i < size; ++i) slot(i)->~T();
+    if (data) HeapAllocator().deallocate(data, capacity * sizeof(T), alignof(T));
+    data = newData;
+    capacity = newCapacity;
+    head = 0;
+}
+
+template <typename T>
+void RingBuffer<T>::Reserve(std::size_t newCapacity) {
+    if (newCapacity <= capacity) return;
+    if (newCapacity > MaxSize()) throw std::length_error("RingBuffer: requested size exceeds MaxSize()");
+    std::size_t rounded = capacity ? capacity : InitialCapacity;
+    while (rounded < newCapacity) rounded *= 2;
+    reallocate(rounded);
+}
+
+// value may alias an element, so it is copied before the buffer can move.
+template <typename T>
+void RingBuffer<T>::PushBack(const T& value) {
+    if (size == capacity) {
+        T copy(value);
+        Reserve(size + 1);
+        ::new (static_cast<void*>(slot(size))) T(std::move(copy));
+    } else {
+        ::new (static_cast<void*>(slot(size))) T(value);
+    }
+    ++size;
+}
+
+template <typename T>
+void RingBuffer<T>::PushFront(const T& value) {
+    if (size == capacity) {
+        T copy(value);
+        Reserve(size + 1);
+        std::size_t before = (head + capacity - 1) & (capacity - 1);
+        ::new (static_cast<void*>(data + before)) T(std::move(copy));
+        head = before;
+    } else {
+        std::size_t before = (head + capacity - 1) & (capacity - 1);
+        ::new (static_cast<void*>(data + before)) T(value);
+        head = before;
+    }
+    ++size;
+}
+
+template <typename T>
+T RingBuffer<T>::PopBack() {
+    if (size == 0) throw std::out_of_range("RingBuffer is empty");
+    T* last = slot(size - 1);
+    T item(std::move(*last));
+    last->~T();
+    --size;
+    return item;
+}
+
+template <typename T>
+T RingBuffer<T>::PopFront() {
+    if (size == 0) throw std::out_of_range("RingBuffer is empty");
+    T* first = data + head;
+    T item(std::move(*first));
+    first->~T();
+    head = (head + 1) & (capacity - 1);
+    --size;
+    return item;
+}
+
+template <typename T>
+const T& RingBuffer<T>::Front() const {
+    if (size == 0) throw std::out_of_range("RingBuffer is empty");
+    return data[head];
+}
+
+template <typename T>
+const T& RingBuffer<T>::Back() const {
+    if (size == 0) throw std::out_of_range("RingBuffer is empty");
+    return *slot(size - 1);
+}
+
+template <typename T>
+const T& RingBuffer<T>::Get(std::size_t index) const {
+    if (index >= size) throw std::out_of_range("Index out of range");
+    return *slot(index);
+}
+
+// Destroys the elements but keeps the buffer for reuse.
+template <typename T>
+void RingBuffer<T>::Clear() {
+    for (std::size_t i = size; i > 0; --i) slot(i - 1)->~T();
+    size = 0;
+    head = 0;
+}
+
+#endif
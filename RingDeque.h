@@ -0,0 +1,76 @@
+#ifndef RINGDEQUE_H
+#define RINGDEQUE_H
+#include "RingBuffer.h"
+
+// Deque over a RingBuffer: same interface as the linked Deque (Deck.h), but
+// pushes and pops at either end reuse one contiguous buffer instead of
+// allocating and freeing a node each time.
+template <typename T>
+class RingDeque {
+private:
+    RingBuffer<T> buffer;
+public:
+    void PushTop(const T& item);
+    void PushFront(const T& item);
+    T PopTop();
+    T PopFront();
+    T Front() const;
+    T Top() const;
+    T Get(std::size_t index) const;
+    std::size_t GetSize() const;
+    void Clear();
+};
+
+template <typename T>
+void RingDeque<T>::PushTop(const T& item) {
+    buffer.PushBack(item);
+}
+
+template <typename T>
+void RingDeque<T>::PushFront(const T& item) {
+    buffer.PushFront(item);
+}
+
+template <typename T>
+T RingDeque<T>::PopTop() {
+    if (GetSize() == 0)
+        throw std::out_of_range("Deque is empty");
+    return buffer.PopBack();
+}
+
+template <typename T>
+T RingDeque<T>::PopFront() {
+    if (GetSize() == 0)
+        throw std::out_of_range("Deque is empty");
+    return buffer.PopFront();
+}
+
+template <typename T>
+T RingDeque<T>::Front() const {
+    if (GetSize() == 0)
+        throw std::out_of_range("Deque is empty");
+    return buffer.Front();
+}
+
+template <typename T>
+T RingDeque<T>::Top() const {
+    if (GetSize() == 0)
+        throw std::out_of_range("Deque is empty");
+    return buffer.Back();
+}
+
+template <typename T>
+T RingDeque<T>::Get(std::size_t index) const {
+    return buffer.Get(index);
+}
+
+template <typename T>
+std::size_t RingDeque<T>::GetSize() const {
+    return buffer.GetSize();
+}
+
+template <typename T>
+void RingDeque<T>::Clear() {
+    buffer.Clear();
+}
+#endif
@@ -0,0 +1,46 @@
+#ifndef RINGQUEUE_H
+#define RINGQUEUE_H
+#include "RingBuffer.h"
+
+// Queue over a RingBuffer; same interface as the linked Queue (Queue.h).
+template <typename T>
+class RingQueue {
+private:
+    RingBuffer<T> buffer;
+public:
+    void Push(const T& item);
+    T Pop();
+    T Front() const;
+    std::size_t GetSize() const;
+    void Clear();
+};
+
+template <typename T>
+void RingQueue<T>::Push(const T& item) {
+    buffer.PushBack(item);
+}
+
+template <typename T>
+T RingQueue<T>::Pop() {
+    if (GetSize() == 0)
+        throw std::out_of_range("Queue is empty");
+    return buffer.PopFront();
+}
+
+template <typename T>
+T RingQueue<T>::Front() const {
+    if (GetSize() == 0)
+        throw std::out_of_range("Queue is empty");
+    return buffer.Front();
+}
+
+template <typename T>
+std::size_t RingQueue<T>::GetSize() const {
+    return buffer.GetSize();
+}
+
+template <typename T>
+void RingQueue<T>::Clear() {
+    buffer.Clear();
+}
+#endif
@@ -0,0 +1,46 @@
+#ifndef RINGSTACK_H
+#define RINGSTACK_H
+#include "RingBuffer.h"
+
+// Stack over a RingBuffer; same interface as the linked Stack (Stack.h).
+template <typename T>
+class RingStack {
+private:
+    RingBuffer<T> buffer;
+public:
+    void Push(const T& item);
+    T Pop();
+    T Top() const;
+    std::size_t GetSize() const;
+    void Clear();
+};
+
+template <typename T>
+void RingStack<T>::Push(const T& item) {
+    buffer.PushBack(item);
+}
+
+template <typename T>
+T RingStack<T>::Pop() {
+    if (GetSize() == 0)
+        throw std::out_of_range("Stack is empty");
+    return buffer.PopBack();
+}
+
+template <typename T>
+T RingStack<T>::Top() const {
+    if (GetSize() == 0)
+        throw std::out_of_range("Stack is empty");
+    return buffer.Back();
+}
+
+template <typename T>
+std::size_t RingStack<T>::GetSize() const {
+    return buffer.GetSize();
+}
+
+template <typename T>
+void RingStack<T>::Clear() {
+    buffer.Clear();
+}
+#endif
@@ -0,0 +1,230 @@
+#ifndef SEGMENTEDARRAY_H
+#define SEGMENTEDARRAY_H
+
+#include <stdexcept>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+#include "DynamicArray.h"
+#include "PoolAllocator.h"
+
+// Growable array stored as fixed-size blocks of BlockSize elements plus an
+// index of block pointers. Appending never moves an existing element: a full
+// last block is followed by a new one and only the (small) block index is
+// reallocated. References and pointers to elements stay valid until the
+// element is removed, and growth needs at most one extra block rather than
+// a second copy of the whole array.
+//
+// Same interface as DynamicArray. Element i lives at
+// blocks[i / BlockSize][i % BlockSize]; BlockSize must be a power of two.
+template <typename T, std::size_t BlockSize = 256>
+class SegmentedArray {
+    static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0, "SegmentedArray: BlockSize must be a power of two");
+
+public:
+    SegmentedArray();
+    SegmentedArray(T* items, std::size_t count);
+    SegmentedArray(const SegmentedArray& other);
+    SegmentedArray(SegmentedArray&& other) noexcept;
+    SegmentedArray& operator=(const SegmentedArray& other);
+    SegmentedArray& operator=(SegmentedArray&& other) noexcept;
+    ~SegmentedArray();
+
+    const T& Get(std::size_t index) const;
+    T& Get(std::size_t index);
+    std::size_t GetSize() const { return size; }
+    void Set(std::size_t index, const T& value);
+    // Assigns elements [start, start + count) to out[0..count), a block at a time.
+    void CopyTo(std::size_t start, std::size_t count, T* out) const;
+
+    void Resize(std::size_t NewSize);
+    void Append(const T& value);
+    void Append(T&& value);
+    template <typename... Args>
+    T& Emplace(Args&&... args);
+
+    bool operator==(const SegmentedArray& other) const {
+        if (size != other.size) return false;
+        for (std::size_t i = 0; i < size; ++i) {
+            if (*slot(i) != *other.slot(i)) return false;
+        }
+        return true;
+    }
+    bool operator!=(const SegmentedArray& other) const {
+        return !(*this == other);
+    }
+
+    std::size_t GetBlockCount() const { return blocks.GetSize(); }
+    static constexpr std::size_t GetBlockSize() { return BlockSize; }
+    static constexpr std::size_t MaxSize() { return PTRDIFF_MAX / sizeof(T); }
+
+private:
+    DynamicArray<T*> blocks;
+    std::size_t size;
+
+    T* slot(std::size_t i) const { return blocks.Get(i / BlockSize) + i % BlockSize; }
+    T* nextSlot();
+    void releaseBlocksFrom(std::size_t firstBlock);
+    void clear();
+};
+
+template <typename T, std::size_t BlockSize>
+SegmentedArray<T, BlockSize>::SegmentedArray() : size(0) {}
+
+template <typename T, std::size_t BlockSize>
+SegmentedArray<T, BlockSize>::SegmentedArray(T* items, std::size_t count) : size(0) {
+    try {
+        for (std::size_t i = 0; i < count; ++i) Append(items[i]);
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+template <typename T, std::size_t BlockSize>
+SegmentedArray<T, BlockSize>::SegmentedArray(const SegmentedArray& other) : size(0) {
+    try {
+        for (std::size_t i = 0; i < other.size; ++i) Append(*other.slot(i));
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+template <typename T, std::size_t BlockSize>
+SegmentedArray<T, BlockSize>::SegmentedArray(SegmentedArray&& other) noexcept
+    : blocks(std::move(other.blocks)), size(other.size)
+{
+    other.size = 0;
+}
+
+template <typename T, std::size_t BlockSize>
+SegmentedArray<T, BlockSize>& SegmentedArray<T, BlockSize>::operator=(const SegmentedArray& other) {
+    if (this == &other) return *this;
+    SegmentedArray copy(other);
+    return *this = std::move(copy);
+}
+
+template <typename T, std::size_t BlockSize>
+SegmentedArray<T, BlockSize>& SegmentedArray<T, BlockSize>::operator=(SegmentedArray&& other) noexcept {
+    if (this == &other) return *this;
+    clear();
+    blocks = std::move(other.blocks);
+    size = other.size;
+    other.size = 0;
+    return *this;
+}
+
+template <typename T, std::size_t BlockSize>
+SegmentedArray<T, BlockSize>::~SegmentedArray() {
+    clear();
+}
+
+template <typename T, std::size_t BlockSize>
+void SegmentedArray<T, BlockSize>::clear() {
+    for (std::size_t i = size; i > 0; --i) slot(i - 1)->~T();
+    size = 0;
+    releaseBlocksFrom(0);
+}
+
+template <typename T, std::size_t BlockSize>
+void SegmentedArray<T, BlockSize>::releaseBlocksFrom(std::size_t firstBlock) {
+    for (std::size_t b = firstBlock; b < blocks.GetSize(); ++b)
+        HeapAllocator().deallocate(blocks.Get(b), BlockSize * sizeof(T), alignof(T));
+    blocks.Resize(firstBlock);
+}
+
+// Raw storage for element size, adding a block when the last one is full.
+template <typename T, std::size_t BlockSize>
+T* SegmentedArray<T, BlockSize>::nextSlot() {
+    if (size == blocks.GetSize() * BlockSize) {
+        if (size >= MaxSize()) throw std::length_error("SegmentedArray: requested size exceeds MaxSize()");
+        T* block = static_cast<T*>(HeapAllocator().allocate(BlockSize * sizeof(T), alignof(T)));
+        try {
+            blocks.Append(block);
+        } catch (...) {
+            HeapAllocator().deallocate(block, BlockSize * sizeof(T), alignof(T));
+            throw;
+        }
+    }
+    return slot(size);
+}
+
+template <typename T, std::size_t BlockSize>
+const T& SegmentedArray<T, BlockSize>::Get(std::size_t index) const {
+    if (index >= size) {
+        throw std::out_of_range("SegmentedArray::Get: index out of range");
+    }
+    return *slot(index);
+}
+
+template <typename T, std::size_t BlockSize>
+T& SegmentedArray<T, BlockSize>::Get(std::size_t index) {
+    if (index >= size) {
+        throw std::out_of_range("SegmentedArray::Get: index out of range");
+    }
+    return *slot(index);
+}
+
+template <typename T, std::size_t BlockSize>
+void SegmentedArray<T, BlockSize>::Set(std::size_t index, const T& value) {
+    if (index >= size) {
+        throw std::out_of_range("SegmentedArray::Set: index out of range");
+    }
+    *slot(index) = value;
+}
+
+template <typename T, std::size_t BlockSize>
+void SegmentedArray<T, BlockSize>::CopyTo(std::size_t start, std::size_t count, T* out) const {
+    if (start > size || count > size - start) {
+        throw std::out_of_range("SegmentedArray::CopyTo: range out of bounds");
+    }
+    while (count > 0) {
+        std::size_t run = std::min(count, BlockSize - start % BlockSize);
+        const T* from = slot(start);
+        std::copy(from, from + run, out);
+        start += run;
+        out += run;
+        count -= run;
+    }
+}
+
+// Shrinking releases the blocks that no longer hold any element.
+template <typename T, std::size_t BlockSize>
+void SegmentedArray<T, BlockSize>::Resize(std::size_t NewSize) {
+    if (NewSize < size) {
+        while (size > NewSize) slot(--size)->~T();
+        releaseBlocksFrom((size + BlockSize - 1) / BlockSize);
+        return;
+    }
+    while (size < NewSize) {
+        ::new (static_cast<void*>(nextSlot())) T();
+        ++size;
+    }
+}
+
+// Elements never move, so value may alias one of them.
+template <typename T, std::size_t BlockSize>
+void SegmentedArray<T, BlockSize>::Append(const T& value) {
+    ::new (static_cast<void*>(nextSlot())) T(value);
+    ++size;
+}
+
+template <typename T, std::size_t BlockSize>
+void SegmentedArray<T, BlockSize>::Append(T&& value) {
+    ::new (static_cast<void*>(nextSlot())) T(std::move(value));
+    ++size;
+}
+
+template <typename T, std::size_t BlockSize>
+template <typename... Args>
+T& SegmentedArray<T, BlockSize>::Emplace(Args&&... args) {
+    T* p = ::new (static_cast<void*>(nextSlot())) T(std::forward<Args>(args)...);
+    ++size;
+    return *p;
+}
+
+#endif
@@ -6,22 +6,37 @@
 #define SEQUENCE_H
 #include <stdexcept>
 #include <string>
+#include <cstddef>
 
 template <typename T>
 class Sequence {
 public:
+    typedef T value_type;
+
     virtual ~Sequence()=default;
     virtual T GetFirst() const=0;
     virtual T GetLast() const=0;
-    virtual T Get(int index) const=0;
-    virtual int GetLength() const=0;
-    virtual Sequence<T>* GetSubsequence(int startindex, int endindex) = 0;
+    virtual T Get(std::size_t index) const=0;
+    virtual std::size_t GetLength() const=0;
+    virtual Sequence<T>* GetSubsequence(std::size_t startindex, std::size_t endindex) = 0;
     virtual Sequence<T>* Append(const T& item)=0;
     virtual Sequence<T>* Prepend(const T& Item)=0;
-    virtual Sequence<T>* Insert(const T& item,int index)=0;
+    virtual Sequence<T>* Insert(const T& item,std::size_t index)=0;
     virtual Sequence<T>* Concat(Sequence<T>* other) =0;
 
+    // Assigns elements [start, start + count) to out[0..count). One virtual
+    // call for the whole range; the default falls back to Get, containers
+    // override it with a bulk copy or a single walk.
+    virtual void CopyRange(std::size_t start, std::size_t count, T* out) const;
 };
 
+template <typename T>
+void Sequence<T>::CopyRange(std::size_t start, std::size_t count, T* out) const {
+    std::size_t length = GetLength();
+    if (start > length || count > length - start)
+        throw std::out_of_range("CopyRange: range out of bounds");
+    for (std::size_t i = 0; i < count; ++i) out[i] = Get(start + i);
+}
+
 
 #endif
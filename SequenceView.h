@@ -0,0 +1,148 @@
+#ifndef SEQUENCEVIEW_H
+#define SEQUENCEVIEW_H
+
+#include "Sequence.h"
+#include "MutableArraySequence.h"
+#include "SmartPointer.h"
+#include <stdexcept>
+#include <cstddef>
+
+// Read-only window onto elements [offset, offset + length) of another
+// sequence. Nothing is copied: Get forwards to the source, which the view
+// keeps alive through a SharedPtr, so a view stays valid after every other
+// owner of the source is gone. Later writes to those elements show through;
+// the source must not shrink below the viewed range.
+//
+// GetSubsequence returns another view. Like ImmutableArraySequence,
+// Append/Prepend/Insert/Concat leave the view alone and return a new
+// MutableArraySequence holding the result.
+template <typename T>
+class SequenceView : public Sequence<T> {
+public:
+    SequenceView(const SharedPtr< Sequence<T> >& source, std::size_t offset, std::size_t length);
+
+    T GetFirst() const override;
+    T GetLast() const override;
+    T Get(std::size_t index) const override;
+    std::size_t GetLength() const override { return length; }
+    Sequence<T>* GetSubsequence(std::size_t startIndex, std::size_t endIndex) override;
+    Sequence<T>* Append(const T& item) override;
+    Sequence<T>* Prepend(const T& item) override;
+    Sequence<T>* Insert(const T& item, std::size_t index) override;
+    Sequence<T>* Concat(Sequence<T>* other) override;
+    void CopyRange(std::size_t start, std::size_t count, T* out) const override;
+
+    // Elements [startIndex, endIndex] of this view, sharing the same source.
+    SequenceView<T> GetSubview(std::size_t startIndex, std::size_t endIndex) const;
+
+    const SharedPtr< Sequence<T> >& GetSource() const { return source; }
+    std::size_t GetOffset() const { return offset; }
+
+private:
+    SharedPtr< Sequence<T> > source;
+    std::size_t offset;
+    std::size_t length;
+
+    MutableArraySequence<T>* Materialise() const;
+};
+
+template <typename T>
+SequenceView<T>::SequenceView(const SharedPtr< Sequence<T> >& source_, std::size_t offset_, std::size_t length_)
+    : source(source_), offset(offset_), length(length_)
+{
+    if (!source) throw std::invalid_argument("SequenceView: null source");
+    std::size_t available = source->GetLength();
+    if (offset > available || length > available - offset)
+        throw std::out_of_range("SequenceView: range exceeds the source");
+}
+
+template <typename T>
+T SequenceView<T>::GetFirst() const {
+    if (length == 0)
+        throw std::out_of_range("Sequence is empty");
+    return source->Get(offset);
+}
+
+template <typename T>
+T SequenceView<T>::GetLast() const {
+    if (length == 0)
+        throw std::out_of_range("Sequence is empty");
+    return source->Get(offset + length - 1);
+}
+
+template <typename T>
+T SequenceView<T>::Get(std::size_t index) const {
+    if (index >= length)
+        throw std::out_of_range("Index out of range");
+    return source->Get(offset + index);
+}
+
+template <typename T>
+SequenceView<T> SequenceView<T>::GetSubview(std::size_t startIndex, std::size_t endIndex) const {
+    if (endIndex >= length || startIndex > endIndex)
+        throw std::out_of_range("Invalid index range");
+    return SequenceView<T>(source, offset + startIndex, endIndex - startIndex + 1);
+}
+
+template <typename T>
+Sequence<T>* SequenceView<T>::GetSubsequence(std::size_t startIndex, std::size_t endIndex) {
+    return new SequenceView<T>(GetSubview(startIndex, endIndex));
+}
+
+template <typename T>
+void SequenceView<T>::CopyRange(std::size_t start, std::size_t count, T* out) const {
+    if (start > length || count > length - start)
+        throw std::out_of_range("CopyRange: range out of bounds");
+    source->CopyRange(offset + start, count, out);
+}
+
+template <typename T>
+MutableArraySequence<T>* SequenceView<T>::Materialise() const {
+    DynamicArray<T> items(length);
+    if (length) source->CopyRange(offset, length, &items.Get(0));
+    return new MutableArraySequence<T>(length ? &items.Get(0) : nullptr, length);
+}
+
+template <typename T>
+Sequence<T>* SequenceView<T>::Append(const T& item) {
+    MutableArraySequence<T>* result = Materialise();
+    result->Append(item);
+    return result;
+}
+
+template <typename T>
+Sequence<T>* SequenceView<T>::Prepend(const T& item) {
+    MutableArraySequence<T>* result = Materialise();
+    result->Prepend(item);
+    return result;
+}
+
+template <typename T>
+Sequence<T>* SequenceView<T>::Insert(const T& item, std::size_t index) {
+    if (index > length)
+        throw std::out_of_range("Index out of range");
+    MutableArraySequence<T>* result = Materialise();
+    result->Insert(item, index);
+    return result;
+}
+
+template <typename T>
+Sequence<T>* SequenceView<T>::Concat(Sequence<T>* other) {
+    MutableArraySequence<T>* view = Materialise();
+    Sequence<T>* result = view->Concat(other);
+    delete view;
+    return result;
+}
+
+// Zero-copy counterpart of GetSubsequence: a view of elements
+// [startIndex, endIndex] of seq that shares ownership of it.
+template <typename S>
+SequenceView<typename S::value_type> GetSubsequenceView(const SharedPtr<S>& seq, std::size_t startIndex, std::size_t endIndex) {
+    typedef typename S::value_type T;
+    if (!seq) throw std::invalid_argument("GetSubsequenceView: null sequence");
+    if (endIndex >= seq->GetLength() || startIndex > endIndex)
+        throw std::out_of_range("Invalid index range");
+    return SequenceView<T>(SharedPtr< Sequence<T> >(seq), startIndex, endIndex - startIndex + 1);
+}
+
+#endif
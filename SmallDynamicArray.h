@@ -0,0 +1,34 @@
+#ifndef SMALLDYNAMICARRAY_H
+#define SMALLDYNAMICARRAY_H
+
+#include <cstddef>
+
+#include "ArrayStorage.h"
+#include "PoolAllocator.h"
+
+// DynamicArray with room for N elements inside the object itself. Up to N
+// elements never touch the heap; the N+1-th moves everything to a buffer
+// from Alloc that then grows like DynamicArray's. Meant for members that are
+// usually empty or tiny (children of a lazy node, a generator's injected
+// values), where the owning object is already heap-allocated and one more
+// allocation per instance would dominate.
+//
+// Same interface and storage (ArrayStorage) as DynamicArray. Moving an
+// inline array moves its elements one by one, so a move is only noexcept
+// when T's move constructor is.
+template <typename T, std::size_t N, typename Alloc = MallocAllocator>
+class SmallDynamicArray : public ArrayStorage<T, N, Alloc> {
+    static_assert(N > 0, "SmallDynamicArray: use DynamicArray for N == 0");
+    typedef ArrayStorage<T, N, Alloc> Storage;
+
+public:
+    SmallDynamicArray() = default;
+    explicit SmallDynamicArray(const Alloc& alloc) : Storage(alloc) {}
+
+    // True while the elements still live in the inline buffer.
+    bool IsInline() const { return !this->onHeap(); }
+
+    static constexpr std::size_t InlineCapacity() { return N; }
+};
+
+#endif
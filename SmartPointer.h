@@ -4,8 +4,21 @@
 #include <utility>
 #include <new>
 #include <typeinfo>
+#include <type_traits>
 #include <cassert>
 #include <iostream>
+#include <atomic>
+#include <cstdint>
+#include "PoolAllocator.h"
+#include "EpochReclamation.h"
+#include "SmartPointerStats.h"
+
+
+// Derived-to-base conversions between smart pointers are resolved at
+// compile time: the converting constructors only exist when U* converts
+// implicitly to T*. Downcasts go through StaticPointerCast/DynamicPointerCast.
+template<class U, class T>
+struct EnableIfConvertible : std::enable_if<std::is_convertible<U*, T*>::value> {};
 
 
 template <class T>
@@ -17,28 +30,17 @@ public:
     explicit UniquePtr(T* p) : ptr_(p) {}
     UniquePtr(UniquePtr&& other) : ptr_(other.release()) {}
 
-    template<class U>
-    UniquePtr(UniquePtr<U>&& other) {
-        U* up = other.get();
-        if (!up) { ptr_ = 0; other.release(); return; }
-        T* casted = dynamic_cast<T*>(up);
-        if (casted) { ptr_ = casted; other.release(); }
-        else throw std::bad_cast();
-    }
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
+    UniquePtr(UniquePtr<U>&& other) : ptr_(other.release()) {}
 
     UniquePtr& operator=(UniquePtr&& other) {
         if (this != &other) reset(other.release());
         return *this;
     }
 
-    template<class U>
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
     UniquePtr& operator=(UniquePtr<U>&& other) {
-        if ((void*)this == (void*)&other) return *this;
-        U* up = other.get();
-        if (!up) { reset(0); other.release(); return *this; }
-        T* casted = dynamic_cast<T*>(up);
-        if (casted) { reset(casted); other.release(); }
-        else throw std::bad_cast();
+        reset(other.release());
         return *this;
     }
 
@@ -64,6 +66,7 @@ private:
 
 template<class T, class... Args>
 UniquePtr<T> MakeUnique(Args&&... args) {
+    SmartPointerStats::OnMakeUnique();
     return UniquePtr<T>(new T(static_cast<Args&&>(args)...));
 }
 
@@ -97,66 +100,266 @@ private:
 
 template<class T>
 UniquePtr<T[]> MakeUnique(std::size_t n) {
+    SmartPointerStats::OnMakeUnique();
     return UniquePtr<T[]>(new T[n]());
 }
 
 
+// Reference counting policies. NonAtomicRefCount is the cheap single-threaded
+// default; AtomicRefCount makes SharedPtr copies/releases safe across threads
+// (relaxed increments, acquire/release decrements).
+// Define SMARTPOINTER_ATOMIC_REFCOUNT to make the atomic policy the default,
+// or pick it per pointer type: SharedPtr<T, AtomicRefCount>.
+// deferred_reclaim policies hand objects whose count reached zero to the
+// global EpochDomain instead of destroying them on the spot.
+struct NonAtomicRefCount {
+    typedef std::size_t counter_type;
+    static constexpr bool deferred_reclaim = false;
+    static void increment(counter_type& c) { ++c; }
+    static std::size_t decrement(counter_type& c) { return --c; }
+    static std::size_t load(const counter_type& c) { return c; }
+    static bool increment_if_nonzero(counter_type& c) {
+        if (c == 0) return false;
+        ++c;
+        return true;
+    }
+};
+
+struct AtomicRefCount {
+    typedef std::atomic<std::size_t> counter_type;
+    static constexpr bool deferred_reclaim = false;
+    static void increment(counter_type& c) { c.fetch_add(1, std::memory_order_relaxed); }
+    static std::size_t decrement(counter_type& c) { return c.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+    static std::size_t load(const counter_type& c) { return c.load(std::memory_order_acquire); }
+    static bool increment_if_nonzero(counter_type& c) {
+        std::size_t cur = c.load(std::memory_order_relaxed);
+        while (cur != 0) {
+            if (c.compare_exchange_weak(cur, cur + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+};
+
+// Atomic counts, but the last release retires the object into the epoch
+// domain. Readers that hold an EpochGuard may then walk raw pointers (e.g.
+// AtomicSharedPtr::peek and the nodes reachable from it) without touching
+// any count; the object is destroyed once no such reader can remain.
+// Define SMARTPOINTER_EPOCH_RECLAIM to make it the default.
+struct EpochRefCount : AtomicRefCount {
+    static constexpr bool deferred_reclaim = true;
+};
+
+#if defined(SMARTPOINTER_EPOCH_RECLAIM)
+typedef EpochRefCount DefaultRefCount;
+#elif defined(SMARTPOINTER_ATOMIC_REFCOUNT)
+typedef AtomicRefCount DefaultRefCount;
+#else
+typedef NonAtomicRefCount DefaultRefCount;
+#endif
+
+// Allocator used by MakeShared. Define SMARTPOINTER_NO_POOL to fall back to
+// plain operator new.
+#ifdef SMARTPOINTER_NO_POOL
+typedef HeapAllocator DefaultSharedAllocator;
+#else
+typedef PoolAllocator DefaultSharedAllocator;
+#endif
+
+
+// strong counts SharedPtr owners. weak counts WeakPtr observers plus one
+// for the whole group of strong owners, so the block is freed exactly when
+// the last of either kind goes away.
+template<class Policy = DefaultRefCount>
 struct ControlBlockBase {
-    std::size_t strong;
-    std::size_t weak;
-    ControlBlockBase() : strong(1), weak(0) {}
+    typename Policy::counter_type strong;
+    typename Policy::counter_type weak;
+    ControlBlockBase* pending_next;
+    ControlBlockBase() : strong(1), weak(1), pending_next(0) { SmartPointerStats::OnBlockCreated(); }
+    explicit ControlBlockBase(std::size_t initialStrong) : strong(initialStrong), weak(1), pending_next(0) {
+        SmartPointerStats::OnBlockCreated();
+    }
     virtual void destroy_object() = 0;
-    virtual ~ControlBlockBase() {}
+    virtual void destroy_block() { delete this; }
+    virtual ~ControlBlockBase() { SmartPointerStats::OnBlockDestroyed(); }
+
+    void release_weak() {
+        if (Policy::decrement(weak) == 0) destroy_block();
+    }
 };
 
 
-template<class U>
-struct ControlBlock : ControlBlockBase {
+template<class U, class Policy = DefaultRefCount>
+struct ControlBlock : ControlBlockBase<Policy> {
     U* ptr;
     explicit ControlBlock(U* p) : ptr(p) {}
     void destroy_object() override { delete ptr; ptr = 0; }
 };
 
 
-template<class U>
-struct ControlBlockArray : ControlBlockBase {
+// Control block and object in one allocation obtained from Alloc (used by
+// AllocateShared/MakeShared). The allocator is kept as an empty base.
+template<class U, class Policy = DefaultRefCount, class Alloc = HeapAllocator>
+struct ControlBlockInline : ControlBlockBase<Policy>, private Alloc {
+    alignas(U) unsigned char storage[sizeof(U)];
+
+    template<class... Args>
+    explicit ControlBlockInline(const Alloc& a, Args&&... args) : Alloc(a) {
+        ::new (static_cast<void*>(storage)) U(static_cast<Args&&>(args)...);
+    }
+    U* object() { return reinterpret_cast<U*>(storage); }
+    void destroy_object() override { object()->~U(); }
+    void destroy_block() override {
+        Alloc a(*this);
+        this->~ControlBlockInline();
+        a.deallocate(this, sizeof(ControlBlockInline), alignof(ControlBlockInline));
+    }
+};
+
+
+template<class U, class Policy = DefaultRefCount>
+struct ControlBlockArray : ControlBlockBase<Policy> {
     U* ptr;
     explicit ControlBlockArray(U* p) : ptr(p) {}
     void destroy_object() override { delete[] ptr; ptr = 0; }
 };
 
-template<class T>
+
+// Control block followed by the array elements in one allocation obtained
+// from Alloc (used by AllocateSharedArray/MakeSharedArray). constructed
+// tracks how many elements exist, so a throwing element constructor can be
+// unwound.
+template<class U, class Policy = DefaultRefCount, class Alloc = HeapAllocator>
+struct ControlBlockInlineArray : ControlBlockBase<Policy>, private Alloc {
+    std::size_t length;
+    std::size_t constructed;
+
+    ControlBlockInlineArray(const Alloc& a, std::size_t n) : Alloc(a), length(n), constructed(0) {}
+
+    static std::size_t header() { return (sizeof(ControlBlockInlineArray) + alignof(U) - 1) / alignof(U) * alignof(U); }
+    static std::size_t bytes(std::size_t n) { return header() + n * sizeof(U); }
+    static std::size_t align() {
+        return alignof(U) > alignof(ControlBlockInlineArray) ? alignof(U) : alignof(ControlBlockInlineArray);
+    }
+
+    U* elements() { return reinterpret_cast<U*>(reinterpret_cast<unsigned char*>(this) + header()); }
+    void destroy_object() override {
+        U* e = elements();
+        while (constructed > 0) e[--constructed].~U();
+    }
+    void destroy_block() override {
+        Alloc a(*this);
+        std::size_t n = length;
+        this->~ControlBlockInlineArray();
+        a.deallocate(this, bytes(n), align());
+    }
+};
+
+// Intrusive reference counting mix-in: the object is its own control block,
+// so SharedPtr<T> adopts it without allocating one and IntrusivePtr<T> can
+// hold it with a single pointer. Both kinds of owner share the embedded
+// count. The object is created with no owners and is allocated from the
+// MakeShared pool. A WeakPtr to a RefCounted object keeps the whole object
+// (not just the counts) alive until the last observer is gone.
+template<class Policy = DefaultRefCount>
+class RefCounted : public ControlBlockBase<Policy> {
+public:
+    typedef Policy refcount_policy;
+
+    void destroy_object() override {}
+    void destroy_block() override { delete this; }
+
+    static void* operator new(std::size_t bytes) {
+        return DefaultSharedAllocator().allocate(bytes, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    }
+    static void operator delete(void* p, std::size_t bytes) {
+        DefaultSharedAllocator().deallocate(p, bytes, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    }
+
+protected:
+    RefCounted() : ControlBlockBase<Policy>(0) {}
+    RefCounted(const RefCounted&) : ControlBlockBase<Policy>(0) {}
+    RefCounted& operator=(const RefCounted&) { return *this; }
+};
+
+template<class T, class Policy>
+struct IsRefCounted : std::is_base_of<ControlBlockBase<Policy>, T> {};
+
+
+// Destroys objects whose last strong owner is gone. Releases triggered
+// while an object is being destroyed (its SharedPtr members dropping their
+// targets) are queued on a per-thread list and drained by the outermost
+// call, so tearing down an N-deep chain (e.g. repeated LazySequence::
+// AppendValue) runs in constant stack space instead of recursing N times.
+// Under a deferred_reclaim policy the block is retired into the epoch
+// domain instead, which gives the same constant-stack teardown.
+template<class Policy>
+struct DeferredRelease {
+    struct State {
+        ControlBlockBase<Policy>* head = 0;
+        bool draining = false;
+    };
+
+    static void dispose(ControlBlockBase<Policy>* cb) {
+        if constexpr (Policy::deferred_reclaim) {
+            EpochDomain::Global().Retire(cb, &reclaim);
+            return;
+        }
+        State& st = state();
+        cb->pending_next = st.head;
+        st.head = cb;
+        if (st.draining) return;
+        st.draining = true;
+        while (st.head) {
+            ControlBlockBase<Policy>* next = st.head;
+            st.head = next->pending_next;
+            next->destroy_object();
+            next->release_weak();
+        }
+        st.draining = false;
+    }
+
+private:
+    static State& state() {
+        thread_local State st;
+        return st;
+    }
+
+    static void reclaim(void* p) {
+        ControlBlockBase<Policy>* cb = static_cast<ControlBlockBase<Policy>*>(p);
+        cb->destroy_object();
+        cb->release_weak();
+    }
+};
+
+
+template<class T, class Policy = DefaultRefCount> class WeakPtr;
+template<class T, class Policy = DefaultRefCount> class AtomicSharedPtr;
+
+template<class T, class Policy = DefaultRefCount>
 class SharedPtr {
 public:
     typedef T element_type;
+    typedef Policy policy_type;
 
     SharedPtr() : ptr_(0), cb_(0) {}
-    explicit SharedPtr(T* p) {
-        if (p) cb_ = new ControlBlock<T>(p); else cb_ = 0;
-        ptr_ = p;
-    }
+    explicit SharedPtr(T* p) { adopt(p, IsRefCounted<T, Policy>()); }
 
     SharedPtr(const SharedPtr& other) { acquire(other.ptr_, other.cb_); }
 
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
+    SharedPtr(const SharedPtr<U, Policy>& other) { acquire(other.ptr_, other.cb_); }
+
+    // Aliasing constructor: shares ownership with other but points at p.
     template<class U>
-    SharedPtr(const SharedPtr<U>& other) {
-        U* up = other.ptr_;
-        if (!up) { ptr_ = 0; cb_ = 0; return; }
-        T* casted = dynamic_cast<T*>(up);
-        if (casted) acquire(casted, other.cb_); else throw std::bad_cast();
-    }
+    SharedPtr(const SharedPtr<U, Policy>& other, T* p) { acquire(p, other.cb_); }
 
     SharedPtr(SharedPtr&& other) : ptr_(other.ptr_), cb_(other.cb_) {
         other.ptr_ = 0; other.cb_ = 0;
     }
 
-    template<class U>
-    SharedPtr(SharedPtr<U>&& other) {
-        U* up = other.ptr_;
-        if (!up) { ptr_ = 0; cb_ = 0; other.ptr_ = 0; other.cb_ = 0; return; }
-        T* casted = dynamic_cast<T*>(up);
-        if (casted) { ptr_ = casted; cb_ = other.cb_; other.ptr_ = 0; other.cb_ = 0; }
-        else throw std::bad_cast();
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
+    SharedPtr(SharedPtr<U, Policy>&& other) : ptr_(other.ptr_), cb_(other.cb_) {
+        other.ptr_ = 0; other.cb_ = 0;
     }
 
     ~SharedPtr() { release(); }
@@ -166,13 +369,10 @@ public:
         return *this;
     }
 
-    template<class U>
-    SharedPtr& operator=(const SharedPtr<U>& other) {
-        if ((void*)this == (void*)&other) return *this;
-        U* up = other.ptr_;
-        if (!up) { release(); return *this; }
-        T* casted = dynamic_cast<T*>(up);
-        if (casted) { release(); acquire(casted, other.cb_); } else throw std::bad_cast();
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
+    SharedPtr& operator=(const SharedPtr<U, Policy>& other) {
+        SharedPtr tmp(other);
+        swap(tmp);
         return *this;
     }
 
@@ -181,14 +381,10 @@ public:
         return *this;
     }
 
-    template<class U>
-    SharedPtr& operator=(SharedPtr<U>&& other) {
-        if ((void*)this == (void*)&other) return *this;
-        U* up = other.ptr_;
-        if (!up) { release(); return *this; }
-        T* casted = dynamic_cast<T*>(up);
-        if (casted) { release(); ptr_ = casted; cb_ = other.cb_; other.ptr_ = 0; other.cb_ = 0; }
-        else throw std::bad_cast();
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
+    SharedPtr& operator=(SharedPtr<U, Policy>&& other) {
+        SharedPtr tmp(static_cast<SharedPtr<U, Policy>&&>(other));
+        swap(tmp);
         return *this;
     }
 
@@ -196,52 +392,601 @@ public:
     T& operator*() const { assert(ptr_); return *ptr_; }
     T* operator->() const { return ptr_; }
     operator bool() const { return ptr_ != 0; }
-    std::size_t use_count() const { return cb_ ? cb_->strong : 0; }
+    std::size_t use_count() const { return cb_ ? Policy::load(cb_->strong) : 0; }
 
     void reset() { release(); }
     void reset(T* p) {
         release();
-        if (p) { cb_ = new ControlBlock<T>(p); ptr_ = p; } else { cb_ = 0; ptr_ = 0; }
+        adopt(p, IsRefCounted<T, Policy>());
     }
     void swap(SharedPtr& other) { std::swap(ptr_, other.ptr_); std::swap(cb_, other.cb_); }
 
-    template<class U> friend class SharedPtr;
+    template<class U, class P> friend class SharedPtr;
+    template<class U, class P> friend class WeakPtr;
+    template<class U, class P> friend class AtomicSharedPtr;
+    template<class U, class P, class A, class... Args> friend SharedPtr<U, P> AllocateSharedWith(const A& alloc, Args&&... args);
 
 private:
+    typedef ControlBlockBase<Policy> control_block;
+
+    void adopt(T* p, std::false_type) {
+        cb_ = p ? new ControlBlock<T, Policy>(p) : 0;
+        ptr_ = p;
+    }
+
+    void adopt(T* p, std::true_type) {
+        cb_ = p;
+        ptr_ = p;
+        if (cb_) Policy::increment(cb_->strong);
+    }
+
     template<class U>
-    void acquire(U* p, ControlBlockBase* cb) {
+    void acquire(U* p, control_block* cb) {
         ptr_ = static_cast<T*>(p);
         cb_ = cb;
-        if (cb_) cb_->strong += 1;
+        if (cb_) Policy::increment(cb_->strong);
+    }
+
+    void release() {
+        if (!cb_) return;
+        control_block* cb = cb_;
+        ptr_ = 0; cb_ = 0;
+        std::size_t remaining = Policy::decrement(cb->strong);
+        SmartPointerStats::OnRelease(remaining + 1);
+        if (remaining == 0) DeferredRelease<Policy>::dispose(cb);
+    }
+
+    T* ptr_;
+    control_block* cb_;
+};
+
+
+// Shared fixed-size array. Besides adopting a new[] array, it is normally
+// built by MakeSharedArray, which places the control block and the elements
+// in one allocation. slice() yields a sub-range that shares ownership of the
+// whole buffer, so a prefix can be handed to another owner or thread
+// without copying elements.
+template<class T, class Policy>
+class SharedPtr<T[], Policy> {
+public:
+    typedef T element_type;
+    typedef Policy policy_type;
+
+    SharedPtr() : ptr_(0), size_(0), cb_(0) {}
+    SharedPtr(T* p, std::size_t n) : ptr_(p), size_(p ? n : 0), cb_(p ? new ControlBlockArray<T, Policy>(p) : 0) {}
+
+    SharedPtr(const SharedPtr& other) : ptr_(other.ptr_), size_(other.size_), cb_(other.cb_) {
+        if (cb_) Policy::increment(cb_->strong);
+    }
+    SharedPtr(SharedPtr&& other) : ptr_(other.ptr_), size_(other.size_), cb_(other.cb_) {
+        other.ptr_ = 0; other.size_ = 0; other.cb_ = 0;
+    }
+    ~SharedPtr() { release(); }
+
+    SharedPtr& operator=(const SharedPtr& other) {
+        SharedPtr tmp(other);
+        swap(tmp);
+        return *this;
+    }
+    SharedPtr& operator=(SharedPtr&& other) {
+        SharedPtr tmp(static_cast<SharedPtr&&>(other));
+        swap(tmp);
+        return *this;
+    }
+
+    T* get() const { return ptr_; }
+    T& operator[](std::size_t i) const { assert(i < size_); return ptr_[i]; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T* begin() const { return ptr_; }
+    T* end() const { return ptr_ + size_; }
+    operator bool() const { return ptr_ != 0; }
+    std::size_t use_count() const { return cb_ ? Policy::load(cb_->strong) : 0; }
+
+    // Elements [offset, offset + count) sharing this buffer's ownership.
+    SharedPtr slice(std::size_t offset, std::size_t count) const {
+        assert(offset <= size_ && count <= size_ - offset);
+        SharedPtr s(*this);
+        s.ptr_ += offset;
+        s.size_ = count;
+        return s;
+    }
+
+    void reset() { release(); }
+    void swap(SharedPtr& other) {
+        std::swap(ptr_, other.ptr_);
+        std::swap(size_, other.size_);
+        std::swap(cb_, other.cb_);
     }
 
+    template<class U, class P, class A, class Init>
+    friend SharedPtr<U[], P> AllocateSharedArrayWith(const A& alloc, std::size_t n, Init init);
+
+private:
+    typedef ControlBlockBase<Policy> control_block;
+
     void release() {
         if (!cb_) return;
-        if (cb_->strong > 0) {
-            cb_->strong -= 1;
-            if (cb_->strong == 0) {
-                cb_->destroy_object();
-                if (cb_->weak == 0) delete cb_;
+        control_block* cb = cb_;
+        ptr_ = 0; size_ = 0; cb_ = 0;
+        std::size_t remaining = Policy::decrement(cb->strong);
+        SmartPointerStats::OnRelease(remaining + 1);
+        if (remaining == 0) DeferredRelease<Policy>::dispose(cb);
+    }
+
+    T* ptr_;
+    std::size_t size_;
+    control_block* cb_;
+};
+
+
+// Non-owning observer of a SharedPtr-managed object. Keeps the control block
+// alive (not the object); lock() yields a SharedPtr while the object lives.
+template<class T, class Policy>
+class WeakPtr {
+public:
+    typedef T element_type;
+
+    WeakPtr() : ptr_(0), cb_(0) {}
+    WeakPtr(const WeakPtr& other) { observe(other.ptr_, other.cb_); }
+    WeakPtr(WeakPtr&& other) : ptr_(other.ptr_), cb_(other.cb_) { other.ptr_ = 0; other.cb_ = 0; }
+    WeakPtr(const SharedPtr<T, Policy>& sp) { observe(sp.ptr_, sp.cb_); }
+
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
+    WeakPtr(const SharedPtr<U, Policy>& sp) { observe(sp.ptr_, sp.cb_); }
+
+    // The source may already be expired, so the upcast is done on a locked
+    // copy rather than on a pointer to a possibly destroyed object.
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
+    WeakPtr(const WeakPtr<U, Policy>& other) {
+        SharedPtr<U, Policy> sp = other.lock();
+        observe(sp.ptr_, sp.cb_);
+    }
+
+    ~WeakPtr() { reset(); }
+
+    WeakPtr& operator=(const WeakPtr& other) {
+        if (this != &other) { reset(); observe(other.ptr_, other.cb_); }
+        return *this;
+    }
+
+    WeakPtr& operator=(WeakPtr&& other) {
+        if (this != &other) { reset(); ptr_ = other.ptr_; cb_ = other.cb_; other.ptr_ = 0; other.cb_ = 0; }
+        return *this;
+    }
+
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
+    WeakPtr& operator=(const SharedPtr<U, Policy>& sp) {
+        WeakPtr tmp(sp);
+        swap(tmp);
+        return *this;
+    }
+
+    std::size_t use_count() const { return cb_ ? Policy::load(cb_->strong) : 0; }
+    bool expired() const { return use_count() == 0; }
+
+    SharedPtr<T, Policy> lock() const {
+        SharedPtr<T, Policy> sp;
+        if (cb_ && Policy::increment_if_nonzero(cb_->strong)) { sp.ptr_ = ptr_; sp.cb_ = cb_; }
+        return sp;
+    }
+
+    void reset() {
+        if (cb_) cb_->release_weak();
+        ptr_ = 0; cb_ = 0;
+    }
+    void swap(WeakPtr& other) { std::swap(ptr_, other.ptr_); std::swap(cb_, other.cb_); }
+
+    template<class U, class P> friend class WeakPtr;
+
+private:
+    typedef ControlBlockBase<Policy> control_block;
+
+    void observe(T* p, control_block* cb) {
+        ptr_ = p;
+        cb_ = cb;
+        if (cb_) Policy::increment(cb_->weak);
+    }
+
+    T* ptr_;
+    control_block* cb_;
+};
+
+// A SharedPtr slot that can be loaded, stored and compare-exchanged from
+// several threads without a lock (needs AtomicRefCount or EpochRefCount).
+//
+// Split reference counting: the slot holds a pointer to an immutable Box
+// (a SharedPtr plus the box's own count) and, in the top 16 bits of the same
+// word, a count of readers that are in the middle of loading it. A reader
+// bumps that local count, takes a reference on the box, then hands the local
+// count back. A writer that replaces the box folds the pending local count
+// into the box's count before dropping the slot's own reference, so a reader
+// never touches a freed box and never waits for a writer.
+//
+// Under EpochRefCount boxes are retired into the epoch domain as well, so a
+// pinned reader can also peek() at the current value without any count.
+template<class T, class Policy>
+class AtomicSharedPtr {
+public:
+    typedef SharedPtr<T, Policy> value_type;
+
+    // A read-only view of the current value for the duration of one
+    // traversal: an epoch pin and a raw pointer under EpochRefCount, an owned
+    // copy otherwise.
+    class Snapshot {
+    public:
+        explicit Snapshot(const AtomicSharedPtr& slot) : pin_(Policy::deferred_reclaim) {
+            if constexpr (Policy::deferred_reclaim) {
+                ptr_ = slot.peek();
+            } else {
+                held_ = slot.load();
+                ptr_ = held_.get();
             }
         }
-        ptr_ = 0; cb_ = 0;
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        T* get() const { return ptr_; }
+        T* operator->() const { return ptr_; }
+        T& operator*() const { return *ptr_; }
+        explicit operator bool() const { return ptr_ != 0; }
+
+    private:
+        EpochGuard pin_;
+        value_type held_;
+        T* ptr_;
+    };
+
+    AtomicSharedPtr() : word_(0) {}
+    AtomicSharedPtr(const value_type& v) : word_(pack(makeBox(v), 0)) {}
+    ~AtomicSharedPtr() { releaseBox(boxOf(word_.load(std::memory_order_acquire))); }
+
+    AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+    AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+
+    AtomicSharedPtr& operator=(const value_type& v) { store(v); return *this; }
+    operator value_type() const { return load(); }
+
+    value_type load() const {
+        Box* b = acquireBox();
+        if (!b) return value_type();
+        value_type v = b->value;
+        releaseBox(b);
+        return v;
+    }
+
+    void store(const value_type& v) { exchange(v); }
+
+    value_type exchange(const value_type& v) {
+        std::uintptr_t old = word_.exchange(pack(makeBox(v), 0), std::memory_order_acq_rel);
+        Box* ob = boxOf(old);
+        if (!ob) return value_type();
+        ob->refs.fetch_add(localOf(old), std::memory_order_relaxed);
+        value_type prev = ob->value;
+        releaseBox(ob);
+        return prev;
+    }
+
+    // On failure expected receives the current value.
+    bool compare_exchange_strong(value_type& expected, const value_type& desired) {
+        Box* nb = 0;
+        while (true) {
+            Box* cur = acquireBox();
+            if (!sameAs(cur, expected)) {
+                expected = cur ? cur->value : value_type();
+                releaseBox(cur);
+                releaseBox(nb);
+                return false;
+            }
+            if (!nb) nb = makeBox(desired);
+            std::uintptr_t w = word_.load(std::memory_order_relaxed);
+            while (boxOf(w) == cur) {
+                if (word_.compare_exchange_weak(w, pack(nb, 0), std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    if (cur) {
+                        cur->refs.fetch_add(localOf(w), std::memory_order_relaxed);
+                        releaseBox(cur);
+                    }
+                    releaseBox(cur);
+                    return true;
+                }
+            }
+            releaseBox(cur);
+        }
+    }
+
+    bool compare_exchange_weak(value_type& expected, const value_type& desired) {
+        return compare_exchange_strong(expected, desired);
+    }
+
+    bool is_lock_free() const { return true; }
+
+    // The current value without taking a reference. Only valid under
+    // EpochRefCount and only while the caller holds an EpochGuard.
+    T* peek() const {
+        static_assert(Policy::deferred_reclaim, "peek needs an epoch-reclaimed policy; use load or Snapshot");
+        Box* b = boxOf(word_.load(std::memory_order_acquire));
+        return b ? b->value.get() : 0;
+    }
+
+private:
+    static_assert(sizeof(std::uintptr_t) == 8, "AtomicSharedPtr packs a local count into the upper pointer bits");
+
+    struct Box {
+        value_type value;
+        std::atomic<std::size_t> refs;
+        explicit Box(const value_type& v) : value(v), refs(1) {}
+
+        static void* operator new(std::size_t bytes) {
+            return DefaultSharedAllocator().allocate(bytes, alignof(Box));
+        }
+        static void operator delete(void* p, std::size_t bytes) {
+            DefaultSharedAllocator().deallocate(p, bytes, alignof(Box));
+        }
+    };
+
+    static constexpr int LocalShift = 48;
+    static constexpr std::uintptr_t LocalOne = std::uintptr_t(1) << LocalShift;
+    static constexpr std::uintptr_t PointerMask = LocalOne - 1;
+
+    static std::uintptr_t pack(Box* b, std::uintptr_t local) { return reinterpret_cast<std::uintptr_t>(b) | (local << LocalShift); }
+    static Box* boxOf(std::uintptr_t w) { return reinterpret_cast<Box*>(w & PointerMask); }
+    static std::size_t localOf(std::uintptr_t w) { return static_cast<std::size_t>(w >> LocalShift); }
+
+    static Box* makeBox(const value_type& v) { return v ? new Box(v) : 0; }
+
+    static bool sameAs(Box* b, const value_type& v) {
+        if (!b) return !v.ptr_ && !v.cb_;
+        return b->value.ptr_ == v.ptr_ && b->value.cb_ == v.cb_;
+    }
+
+    static void releaseBox(Box* b) {
+        if (!b || b->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        if constexpr (Policy::deferred_reclaim) EpochDomain::Global().Retire(b, &deleteBox);
+        else delete b;
+    }
+
+    static void deleteBox(void* p) { delete static_cast<Box*>(p); }
+
+    // Returns the current box with one reference taken for the caller.
+    Box* acquireBox() const {
+        std::uintptr_t w = word_.fetch_add(LocalOne, std::memory_order_acquire) + LocalOne;
+        Box* b = boxOf(w);
+        if (b) b->refs.fetch_add(1, std::memory_order_relaxed);
+        while (boxOf(w) == b) {
+            if (word_.compare_exchange_weak(w, w - LocalOne, std::memory_order_release, std::memory_order_relaxed)) return b;
+        }
+        // A writer replaced the box and already counted our pending load.
+        if (b) b->refs.fetch_sub(1, std::memory_order_relaxed);
+        return b;
+    }
+
+    mutable std::atomic<std::uintptr_t> word_;
+};
+
+// Under the single-threaded policy the slot is a plain SharedPtr with the
+// same interface, so code can be written once against AtomicSharedPtr<T>.
+template<class T>
+class AtomicSharedPtr<T, NonAtomicRefCount> {
+public:
+    typedef SharedPtr<T, NonAtomicRefCount> value_type;
+
+    class Snapshot {
+    public:
+        explicit Snapshot(const AtomicSharedPtr& slot) : held_(slot.load()) {}
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        T* get() const { return held_.get(); }
+        T* operator->() const { return held_.get(); }
+        T& operator*() const { return *held_; }
+        explicit operator bool() const { return static_cast<bool>(held_); }
+
+    private:
+        value_type held_;
+    };
+
+    AtomicSharedPtr() {}
+    AtomicSharedPtr(const value_type& v) : value_(v) {}
+
+    AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+    AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+
+    AtomicSharedPtr& operator=(const value_type& v) { store(v); return *this; }
+    operator value_type() const { return load(); }
+
+    value_type load() const { return value_; }
+    void store(const value_type& v) { value_ = v; }
+    value_type exchange(const value_type& v) {
+        value_type prev = value_;
+        value_ = v;
+        return prev;
+    }
+    bool compare_exchange_strong(value_type& expected, const value_type& desired) {
+        if (value_.ptr_ != expected.ptr_ || value_.cb_ != expected.cb_) { expected = value_; return false; }
+        value_ = desired;
+        return true;
+    }
+    bool compare_exchange_weak(value_type& expected, const value_type& desired) {
+        return compare_exchange_strong(expected, desired);
+    }
+
+    bool is_lock_free() const { return false; }
+
+private:
+    value_type value_;
+};
+
+
+// Single-pointer owner of a RefCounted object.
+template<class T>
+class IntrusivePtr {
+public:
+    typedef T element_type;
+    typedef typename T::refcount_policy policy_type;
+
+    IntrusivePtr() : ptr_(0) {}
+    explicit IntrusivePtr(T* p) : ptr_(p) { retain(); }
+    IntrusivePtr(const IntrusivePtr& other) : ptr_(other.ptr_) { retain(); }
+    IntrusivePtr(IntrusivePtr&& other) : ptr_(other.ptr_) { other.ptr_ = 0; }
+
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
+    IntrusivePtr(const IntrusivePtr<U>& other) : ptr_(other.get()) { retain(); }
+
+    template<class U, class = typename EnableIfConvertible<U, T>::type>
+    IntrusivePtr(const SharedPtr<U, policy_type>& sp) : ptr_(sp.get()) { retain(); }
+
+    ~IntrusivePtr() { reset(); }
+
+    IntrusivePtr& operator=(const IntrusivePtr& other) {
+        IntrusivePtr tmp(other);
+        swap(tmp);
+        return *this;
+    }
+    IntrusivePtr& operator=(IntrusivePtr&& other) {
+        if (this != &other) { reset(); ptr_ = other.ptr_; other.ptr_ = 0; }
+        return *this;
+    }
+
+    T* get() const { return ptr_; }
+    T& operator*() const { assert(ptr_); return *ptr_; }
+    T* operator->() const { return ptr_; }
+    operator bool() const { return ptr_ != 0; }
+    std::size_t use_count() const { return ptr_ ? policy_type::load(block()->strong) : 0; }
+
+    SharedPtr<T, policy_type> share() const { return SharedPtr<T, policy_type>(ptr_); }
+
+    void reset() {
+        if (!ptr_) return;
+        ControlBlockBase<policy_type>* cb = block();
+        ptr_ = 0;
+        std::size_t remaining = policy_type::decrement(cb->strong);
+        SmartPointerStats::OnRelease(remaining + 1);
+        if (remaining == 0) DeferredRelease<policy_type>::dispose(cb);
     }
+    void swap(IntrusivePtr& other) { std::swap(ptr_, other.ptr_); }
+
+private:
+    ControlBlockBase<policy_type>* block() const { return ptr_; }
+    void retain() { if (ptr_) policy_type::increment(block()->strong); }
 
     T* ptr_;
-    ControlBlockBase* cb_;
 };
 
+template<class T, class... Args>
+IntrusivePtr<T> MakeIntrusive(Args&&... args) {
+    return IntrusivePtr<T>(new T(static_cast<Args&&>(args)...));
+}
+
+
+template<class T, class Policy, class Alloc, class... Args>
+SharedPtr<T, Policy> AllocateSharedWith(const Alloc& alloc, Args&&... args) {
+    static_assert(!IsRefCounted<T, Policy>::value, "RefCounted types carry their own count; use MakeShared");
+    SmartPointerStats::OnMakeShared();
+    typedef ControlBlockInline<T, Policy, Alloc> Block;
+    Alloc a(alloc);
+    void* mem = a.allocate(sizeof(Block), alignof(Block));
+    Block* cb;
+    try {
+        cb = ::new (mem) Block(a, static_cast<Args&&>(args)...);
+    } catch (...) {
+        a.deallocate(mem, sizeof(Block), alignof(Block));
+        throw;
+    }
+    SharedPtr<T, Policy> sp;
+    sp.ptr_ = cb->object();
+    sp.cb_ = cb;
+    return sp;
+}
+
+template<class T, class Alloc, class... Args>
+SharedPtr<T> AllocateShared(const Alloc& alloc, Args&&... args) {
+    return AllocateSharedWith<T, DefaultRefCount>(alloc, static_cast<Args&&>(args)...);
+}
+
+template<class T, class Policy, class... Args>
+SharedPtr<T, Policy> MakeSharedWith(Args&&... args) {
+    if constexpr (IsRefCounted<T, Policy>::value) {
+        SmartPointerStats::OnMakeShared();
+        return SharedPtr<T, Policy>(new T(static_cast<Args&&>(args)...));
+    } else {
+        return AllocateSharedWith<T, Policy>(DefaultSharedAllocator(), static_cast<Args&&>(args)...);
+    }
+}
+
 template<class T, class... Args>
 SharedPtr<T> MakeShared(Args&&... args) {
-    T* raw = new T(static_cast<Args&&>(args)...);
-    return SharedPtr<T>(raw);
+    return MakeSharedWith<T, DefaultRefCount>(static_cast<Args&&>(args)...);
+}
+
+template<class T, class U, class Policy>
+SharedPtr<T, Policy> StaticPointerCast(const SharedPtr<U, Policy>& sp) {
+    return SharedPtr<T, Policy>(sp, static_cast<T*>(sp.get()));
+}
+
+template<class T, class U, class Policy>
+SharedPtr<T, Policy> DynamicPointerCast(const SharedPtr<U, Policy>& sp) {
+    T* casted = dynamic_cast<T*>(sp.get());
+    if (!casted) return SharedPtr<T, Policy>();
+    return SharedPtr<T, Policy>(sp, casted);
+}
+
+template<class T, class U>
+UniquePtr<T> StaticPointerCast(UniquePtr<U>&& up) {
+    return UniquePtr<T>(static_cast<T*>(up.release()));
+}
+
+// On failure the source keeps its object and an empty pointer is returned.
+template<class T, class U>
+UniquePtr<T> DynamicPointerCast(UniquePtr<U>&& up) {
+    T* casted = dynamic_cast<T*>(up.get());
+    if (!casted) return UniquePtr<T>();
+    up.release();
+    return UniquePtr<T>(casted);
+}
+
+// Builds an n-element shared array whose element i is init(i).
+template<class T, class Policy, class Alloc, class Init>
+SharedPtr<T[], Policy> AllocateSharedArrayWith(const Alloc& alloc, std::size_t n, Init init) {
+    SmartPointerStats::OnMakeShared();
+    typedef ControlBlockInlineArray<T, Policy, Alloc> Block;
+    Alloc a(alloc);
+    void* mem = a.allocate(Block::bytes(n), Block::align());
+    Block* cb = ::new (mem) Block(a, n);
+    T* e = cb->elements();
+    try {
+        for (; cb->constructed < n; ++cb->constructed) ::new (static_cast<void*>(e + cb->constructed)) T(init(cb->constructed));
+    } catch (...) {
+        cb->destroy_object();
+        cb->destroy_block();
+        throw;
+    }
+    SharedPtr<T[], Policy> sp;
+    sp.ptr_ = e;
+    sp.size_ = n;
+    sp.cb_ = cb;
+    return sp;
+}
+
+template<class T, class Alloc>
+SharedPtr<T[]> AllocateSharedArray(const Alloc& alloc, std::size_t n) {
+    return AllocateSharedArrayWith<T, DefaultRefCount>(alloc, n, [](std::size_t) { return T(); });
 }
 
 template<class T>
 SharedPtr<T[]> MakeSharedArray(std::size_t n) {
-    T* raw = new T[n]();
-    SharedPtr<T[]> sp;
-    sp.ptr_ = raw;
-    sp.cb_ = new ControlBlockArray<T>(raw);
-    return sp;
+    return AllocateSharedArray<T>(DefaultSharedAllocator(), n);
+}
+
+template<class T>
+SharedPtr<T[]> MakeSharedArray(std::size_t n, const T& value) {
+    return AllocateSharedArrayWith<T, DefaultRefCount>(DefaultSharedAllocator(), n, [&value](std::size_t) -> const T& { return value; });
+}
+
+// Element i is init(i); used to snapshot an existing sequence into one
+// shared buffer.
+template<class T, class Init>
+SharedPtr<T[]> GenerateSharedArray(std::size_t n, Init init) {
+    return AllocateSharedArrayWith<T, DefaultRefCount>(DefaultSharedAllocator(), n, init);
 }
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+// Optional runtime counters for the smart pointers. Define
+// SMARTPOINTER_STATS to enable them; otherwise every hook is an empty inline
+// function and compiles away.
+//
+// Tracked: control blocks created/destroyed, live and peak live blocks,
+// MakeShared/MakeUnique calls, and a histogram of use_count seen by each
+// SharedPtr/IntrusivePtr release (bucket i holds counts in [2^i, 2^(i+1))).
+// All counters are relaxed atomics, so the hooks never block.
+class SmartPointerStats {
+public:
+#ifdef SMARTPOINTER_STATS
+    static constexpr bool Enabled = true;
+#else
+    static constexpr bool Enabled = false;
+#endif
+
+    static constexpr std::size_t HistogramBuckets = 16;
+
+    static void OnBlockCreated() {
+        if constexpr (Enabled) {
+            Registry& r = registry();
+            r.created.fetch_add(1, std::memory_order_relaxed);
+            std::size_t live = r.live.fetch_add(1, std::memory_order_relaxed) + 1;
+            std::size_t peak = r.peak.load(std::memory_order_relaxed);
+            while (live > peak && !r.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        }
+    }
+
+    static void OnBlockDestroyed() {
+        if constexpr (Enabled) {
+            Registry& r = registry();
+            r.destroyed.fetch_add(1, std::memory_order_relaxed);
+            r.live.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    static void OnMakeShared() {
+        if constexpr (Enabled) registry().makeShared.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void OnMakeUnique() {
+        if constexpr (Enabled) registry().makeUnique.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // useCount is the strong count the releasing owner saw, itself included.
+    static void OnRelease(std::size_t useCount) {
+        if constexpr (Enabled) registry().histogram[bucketOf(useCount)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::size_t Live() { return registry().live.load(std::memory_order_relaxed); }
+    static std::size_t Peak() { return registry().peak.load(std::memory_order_relaxed); }
+    static std::size_t Created() { return registry().created.load(std::memory_order_relaxed); }
+    static std::size_t Destroyed() { return registry().destroyed.load(std::memory_order_relaxed); }
+
+    // Zeroes the counters and restarts the rate clock. Peak restarts from
+    // the current live count.
+    static void Reset() {
+        Registry& r = registry();
+        r.created.store(0, std::memory_order_relaxed);
+        r.destroyed.store(0, std::memory_order_relaxed);
+        r.peak.store(r.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        r.makeShared.store(0, std::memory_order_relaxed);
+        r.makeUnique.store(0, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < HistogramBuckets; ++i) r.histogram[i].store(0, std::memory_order_relaxed);
+        r.startNanos.store(nowNanos(), std::memory_order_relaxed);
+    }
+
+    // Writes metric,value rows, then one row per histogram bucket named
+    // release_use_count_<lo>_<hi>.
+    static void DumpCSV(std::ostream& out) {
+        Registry& r = registry();
+        double seconds = (nowNanos() - r.startNanos.load(std::memory_order_relaxed)) / 1e9;
+        std::size_t created = r.created.load(std::memory_order_relaxed);
+
+        out << "metric,value\n";
+        out << "enabled," << (Enabled ? 1 : 0) << "\n";
+        out << "elapsed_seconds," << seconds << "\n";
+        out << "blocks_created," << created << "\n";
+        out << "blocks_destroyed," << r.destroyed.load(std::memory_order_relaxed) << "\n";
+        out << "blocks_live," << r.live.load(std::memory_order_relaxed) << "\n";
+        out << "blocks_peak," << r.peak.load(std::memory_order_relaxed) << "\n";
+        out << "allocations_per_second," << (seconds > 0 ? created / seconds : 0.0) << "\n";
+        out << "make_shared_calls," << r.makeShared.load(std::memory_order_relaxed) << "\n";
+        out << "make_unique_calls," << r.makeUnique.load(std::memory_order_relaxed) << "\n";
+        for (std::size_t i = 0; i < HistogramBuckets; ++i) {
+            std::size_t lo = std::size_t(1) << i;
+            out << "release_use_count_" << lo << "_";
+            if (i + 1 == HistogramBuckets) out << "inf";
+            else out << (lo << 1) - 1;
+            out << "," << r.histogram[i].load(std::memory_order_relaxed) << "\n";
+        }
+    }
+
+private:
+    struct Registry {
+        std::atomic<std::size_t> created{0};
+        std::atomic<std::size_t> destroyed{0};
+        std::atomic<std::size_t> live{0};
+        std::atomic<std::size_t> peak{0};
+        std::atomic<std::size_t> makeShared{0};
+        std::atomic<std::size_t> makeUnique{0};
+        std::atomic<std::size_t> histogram[HistogramBuckets] = {};
+        std::atomic<std::int64_t> startNanos{nowNanos()};
+    };
+
+    // Leaked so blocks released during static destruction still count.
+    static Registry& registry() {
+        static Registry* r = new Registry();
+        return *r;
+    }
+
+    static std::size_t bucketOf(std::size_t n) {
+        std::size_t b = 0;
+        while (n > 1 && b + 1 < HistogramBuckets) { n >>= 1; ++b; }
+        return b;
+    }
+
+    static std::int64_t nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
@@ -16,7 +16,7 @@ public:
     void Push(const T& item);
     T Pop();
     T Top() const;
-    int GetSize() const;
+    std::size_t GetSize() const;
     void Clear();
 };
 
@@ -57,14 +57,14 @@ T Stack<T>::Top() const {
 }
 
 template <typename T>
-int Stack<T>::GetSize() const {
+std::size_t Stack<T>::GetSize() const {
     return sequence->GetLength();
 }
 
 template <typename T>
 void Stack<T>::Clear() {
-    while (GetSize()!=0) {
-        Pop();
-    }
+    LinkedSequenceMutable<T>* empty = new LinkedSequenceMutable<T>();
+    delete sequence;
+    sequence = empty;
 }
 #endif
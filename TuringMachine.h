@@ -5,6 +5,7 @@
 #include <sstream>
 #include <functional>
 #include <algorithm>
+#include <cstddef>
 
 #include "DynamicArray.h"   
 #include "LazySequence.h"   
@@ -30,9 +31,23 @@ class TuringTape {
 private:
     DynamicArray<char> leftTape; 
     DynamicArray<char> rightTape; 
-    int headPos;
+    std::ptrdiff_t headPos;
     char blank;
 
+    // Cell -1 is leftTape[0], cell -2 is leftTape[1], ...
+    static size_t LeftIndex(std::ptrdiff_t pos) { return static_cast<size_t>(-(pos + 1)); }
+
+    char CellAt(std::ptrdiff_t pos) const {
+        if (pos >= 0) {
+            size_t idx = static_cast<size_t>(pos);
+            if (idx < rightTape.GetSize()) return rightTape.Get(idx);
+        } else {
+            size_t idx = LeftIndex(pos);
+            if (idx < leftTape.GetSize()) return leftTape.Get(idx);
+        }
+        return blank;
+    }
+
 public:
     TuringTape(char blankSym = '_') : leftTape(), rightTape(), headPos(0), blank(blankSym) {}
 
@@ -44,24 +59,17 @@ public:
         headPos = 0;
     }
 
-    char Read() const {
-        if (headPos >= 0) {
-            if (headPos < rightTape.GetSize()) return rightTape.Get(headPos);
-        } else {
-            int idx = -headPos - 1;
-            if (idx < leftTape.GetSize()) return leftTape.Get(idx);
-        }
-        return blank;
-    }
+    char Read() const { return CellAt(headPos); }
 
     void Write(char c) {
         if (headPos >= 0) {
-            if (headPos >= rightTape.GetSize()) {
-                rightTape.Resize(headPos + 1);
+            size_t idx = static_cast<size_t>(headPos);
+            if (idx >= rightTape.GetSize()) {
+                rightTape.Resize(idx + 1);
             }
-            rightTape.Set(headPos, c);
+            rightTape.Set(idx, c);
         } else {
-            int idx = -headPos - 1;
+            size_t idx = LeftIndex(headPos);
             if (idx >= leftTape.GetSize()) {
                 leftTape.Resize(idx + 1);
             }
@@ -74,14 +82,8 @@ public:
     
     std::string Snapshot(int radiusLeft, int radiusRight) const {
         std::stringstream ss;
-        for (int i = headPos - radiusLeft; i <= headPos + radiusRight; ++i) {
-            char c = blank;
-            if (i >= 0) {
-                if (i < rightTape.GetSize()) c = rightTape.Get(i);
-            } else {
-                int idx = -i - 1;
-                if (idx < leftTape.GetSize()) c = leftTape.Get(idx);
-            }
+        for (std::ptrdiff_t i = headPos - radiusLeft; i <= headPos + radiusRight; ++i) {
+            char c = CellAt(i);
             
             if (i == headPos) ss << "[" << c << "]";
             else ss << c;
@@ -91,11 +93,11 @@ public:
 
     std::string ToString() const {
         std::string res = "";
-        for(int i = leftTape.GetSize() - 1; i >= 0; --i) {
-            char c = leftTape.Get(i);
+        for(size_t i = leftTape.GetSize(); i > 0; --i) {
+            char c = leftTape.Get(i - 1);
             if(c != 0) res += c; else res += blank;
         }
-        for(int i = 0; i < rightTape.GetSize(); ++i) {
+        for(size_t i = 0; i < rightTape.GetSize(); ++i) {
             char c = rightTape.Get(i);
             if(c != 0) res += c; else res += blank;
         }
@@ -114,10 +116,10 @@ public:
 struct TMState {
     TuringTape tape;
     int state;
-    int stepCount;
+    size_t stepCount;
 
     TMState() : tape('_'), state(0), stepCount(0) {}
-    TMState(const TuringTape& t, int s, int count) : tape(t), state(s), stepCount(count) {}
+    TMState(const TuringTape& t, int s, size_t count) : tape(t), state(s), stepCount(count) {}
 
     bool operator==(const TMState& other) const {
         return state == other.state && 
@@ -177,7 +179,7 @@ public:
             TMState next = prev; 
             next.stepCount++;
 
-            for (int i = 0; i < rulesCapture.GetSize(); ++i) {
+            for (size_t i = 0; i < rulesCapture.GetSize(); ++i) {
                 Transition tr = rulesCapture.Get(i);
                 if (tr.fromState == prev.state && tr.readSym == curChar) {
                     next.tape.Write(tr.writeSym);
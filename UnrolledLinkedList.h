@@ -0,0 +1,403 @@
+#ifndef UNROLLEDLINKEDLIST_H
+#define UNROLLEDLINKEDLIST_H
+
+#include <stdexcept>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <cstddef>
+
+#include "PoolAllocator.h"
+
+// Default node capacity: about 256 bytes of elements, at least 4.
+template <typename T>
+constexpr std::size_t UnrolledNodeCapacity() {
+    return 256 / sizeof(T) > 4 ? 256 / sizeof(T) : 4;
+}
+
+template <typename T, std::size_t Capacity>
+struct UnrolledNode {
+    UnrolledNode* next;
+    UnrolledNode* previous;
+    std::size_t count;
+    alignas(T) unsigned char storage[Capacity * sizeof(T)];
+
+    UnrolledNode() : next(nullptr), previous(nullptr), count(0) {}
+    T* items() { return reinterpret_cast<T*>(storage); }
+};
+
+// Doubly linked list whose nodes each hold up to Capacity elements in a
+// small array. Same interface as LinkedList, so LinkedSequence can be built
+// on either. Iteration touches one node per Capacity elements, and an insert
+// or removal shifts at most Capacity elements inside one node.
+//
+// A full node is split in half before an insert. After a removal, a node
+// is merged into its neighbour when together they fill at most half a node,
+// so any two adjacent nodes hold more than Capacity / 2 elements between them.
+// Index lookups walk node by node from the nearest of the head, the tail and
+// the node found by the previous lookup. As with LinkedList, that cursor is
+// updated by const lookups.
+template <typename T, std::size_t Capacity = UnrolledNodeCapacity<T>(), typename Alloc = HeapAllocator>
+class UnrolledLinkedList : private Alloc {
+    static_assert(Capacity >= 2, "UnrolledLinkedList: Capacity must be at least 2");
+
+public:
+    typedef UnrolledNode<T, Capacity> NodeType;
+
+    UnrolledLinkedList();
+    explicit UnrolledLinkedList(const Alloc& alloc);
+    UnrolledLinkedList(T* items, std::size_t count, const Alloc& alloc = Alloc());
+    UnrolledLinkedList(const UnrolledLinkedList& list);
+    UnrolledLinkedList& operator=(const UnrolledLinkedList& list);
+    ~UnrolledLinkedList();
+    void Append(const T& value);
+    void Prepend(const T& value);
+    void Insert(const T& value, std::size_t index);
+    void Remove(std::size_t index);
+    T Get(std::size_t index) const;
+    // Assigns elements [start, start + count) to out[0..count), a node at a time.
+    void CopyTo(std::size_t start, std::size_t count, T* out) const;
+    std::size_t GetLength() const { return size; }
+    T GetFirst() const;
+    T GetLast() const;
+    UnrolledLinkedList* Concat(const UnrolledLinkedList& list);
+    UnrolledLinkedList* GetSublist(std::size_t startIndex, std::size_t endIndex);
+
+    std::size_t GetNodeCount() const { return nodes; }
+    static constexpr std::size_t GetNodeCapacity() { return Capacity; }
+
+private:
+    NodeType* root;
+    NodeType* tail;
+    std::size_t size;
+    std::size_t nodes;
+    mutable NodeType* cursor;
+    mutable std::size_t cursorStart;
+
+    NodeType* nodeFor(std::size_t index, std::size_t& start) const;
+
+    NodeType* makeNode();
+    void freeNode(NodeType* n);
+    NodeType* linkAfter(NodeType* at);
+    void unlink(NodeType* n);
+    void split(NodeType* n);
+    void mergeNext(NodeType* n);
+    void insertAt(NodeType* n, std::size_t offset, T&& value);
+    void clear();
+};
+
+template <typename T, std::size_t Capacity, typename Alloc>
+UnrolledLinkedList<T, Capacity, Alloc>::UnrolledLinkedList()
+    : root(nullptr), tail(nullptr), size(0), nodes(0), cursor(nullptr), cursorStart(0) {}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+UnrolledLinkedList<T, Capacity, Alloc>::UnrolledLinkedList(const Alloc& alloc)
+    : Alloc(alloc), root(nullptr), tail(nullptr), size(0), nodes(0), cursor(nullptr), cursorStart(0) {}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+UnrolledLinkedList<T, Capacity, Alloc>::UnrolledLinkedList(T* items, std::size_t count, const Alloc& alloc)
+    : Alloc(alloc), root(nullptr), tail(nullptr), size(0), nodes(0), cursor(nullptr), cursorStart(0) {
+    try {
+        for (std::size_t i = 0; i < count; ++i) Append(items[i]);
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+UnrolledLinkedList<T, Capacity, Alloc>::UnrolledLinkedList(const UnrolledLinkedList& list)
+    : Alloc(static_cast<const Alloc&>(list)), root(nullptr), tail(nullptr), size(0), nodes(0), cursor(nullptr), cursorStart(0) {
+    try {
+        for (NodeType* n = list.root; n != nullptr; n = n->next)
+            for (std::size_t i = 0; i < n->count; ++i) Append(n->items()[i]);
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+// Rebuilds the nodes with this list's own allocator, which may own their
+// memory (NodePool); if an element copy throws, the list keeps the elements
+// copied so far.
+template <typename T, std::size_t Capacity, typename Alloc>
+UnrolledLinkedList<T, Capacity, Alloc>& UnrolledLinkedList<T, Capacity, Alloc>::operator=(const UnrolledLinkedList& list) {
+    if (this == &list) return *this;
+    clear();
+    for (NodeType* n = list.root; n != nullptr; n = n->next)
+        for (std::size_t i = 0; i < n->count; ++i) Append(n->items()[i]);
+    return *this;
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+UnrolledLinkedList<T, Capacity, Alloc>::~UnrolledLinkedList() {
+    clear();
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::clear() {
+    NodeType* n = root;
+    while (n != nullptr) {
+        NodeType* next = n->next;
+        for (std::size_t i = n->count; i > 0; --i) n->items()[i - 1].~T();
+        freeNode(n);
+        n = next;
+    }
+    root = tail = cursor = nullptr;
+    size = nodes = cursorStart = 0;
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+typename UnrolledLinkedList<T, Capacity, Alloc>::NodeType* UnrolledLinkedList<T, Capacity, Alloc>::makeNode() {
+    void* p = Alloc::allocate(sizeof(NodeType), alignof(NodeType));
+    return ::new (p) NodeType();
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::freeNode(NodeType* n) {
+    n->~NodeType();
+    Alloc::deallocate(n, sizeof(NodeType), alignof(NodeType));
+}
+
+// Links a new empty node after at, or as the head when at is null.
+template <typename T, std::size_t Capacity, typename Alloc>
+typename UnrolledLinkedList<T, Capacity, Alloc>::NodeType* UnrolledLinkedList<T, Capacity, Alloc>::linkAfter(NodeType* at) {
+    NodeType* n = makeNode();
+    n->previous = at;
+    n->next = at ? at->next : root;
+    if (n->next) n->next->previous = n;
+    else tail = n;
+    if (at) at->next = n;
+    else root = n;
+    ++nodes;
+    return n;
+}
+
+// Unlinks and frees an empty node.
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::unlink(NodeType* n) {
+    if (n->previous) n->previous->next = n->next;
+    else root = n->next;
+    if (n->next) n->next->previous = n->previous;
+    else tail = n->previous;
+    if (cursor == n) cursor = nullptr;
+    freeNode(n);
+    --nodes;
+}
+
+// Moves the upper half of a full node into a new node after it.
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::split(NodeType* n) {
+    NodeType* upper = linkAfter(n);
+    std::size_t keep = n->count / 2;
+    T* from = n->items();
+    T* to = upper->items();
+    for (std::size_t i = keep; i < n->count; ++i) {
+        ::new (static_cast<void*>(to + upper->count)) T(std::move(from[i]));
+        ++upper->count;
+    }
+    for (std::size_t i = n->count; i > keep; --i) from[i - 1].~T();
+    n->count = keep;
+}
+
+// Appends n->next's elements to n and frees n->next.
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::mergeNext(NodeType* n) {
+    NodeType* next = n->next;
+    T* from = next->items();
+    for (std::size_t i = 0; i < next->count; ++i) {
+        ::new (static_cast<void*>(n->items() + n->count)) T(std::move(from[i]));
+        ++n->count;
+    }
+    for (std::size_t i = next->count; i > 0; --i) from[i - 1].~T();
+    next->count = 0;
+    unlink(next);
+}
+
+// Inserts into a node with room, shifting the elements after offset up by one.
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::insertAt(NodeType* n, std::size_t offset, T&& value) {
+    T* items = n->items();
+    if (offset == n->count) {
+        ::new (static_cast<void*>(items + n->count)) T(std::move(value));
+    } else {
+        ::new (static_cast<void*>(items + n->count)) T(std::move(items[n->count - 1]));
+        for (std::size_t i = n->count - 1; i > offset; --i) items[i] = std::move(items[i - 1]);
+        items[offset] = std::move(value);
+    }
+    ++n->count;
+    ++size;
+}
+
+// Returns the node holding index (index == size gives the tail) and sets
+// start to the index of its first element. Leaves the cursor there.
+template <typename T, std::size_t Capacity, typename Alloc>
+typename UnrolledLinkedList<T, Capacity, Alloc>::NodeType* UnrolledLinkedList<T, Capacity, Alloc>::nodeFor(std::size_t index, std::size_t& start) const {
+    if (cursor != nullptr && index >= cursorStart && index - cursorStart < cursor->count) {
+        start = cursorStart;
+        return cursor;
+    }
+    NodeType* n = root;
+    start = 0;
+    std::size_t distance = index;
+    if (size - index < distance) {
+        n = tail;
+        start = size - tail->count;
+        distance = size - index;
+    }
+    if (cursor != nullptr) {
+        std::size_t fromCursor = index > cursorStart ? index - cursorStart : cursorStart - index;
+        if (fromCursor < distance) {
+            n = cursor;
+            start = cursorStart;
+        }
+    }
+    while (index >= start + n->count && n->next != nullptr) {
+        start += n->count;
+        n = n->next;
+    }
+    while (index < start) {
+        n = n->previous;
+        start -= n->count;
+    }
+    cursor = n;
+    cursorStart = start;
+    return n;
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::Append(const T& value) {
+    T copy(value);
+    if (tail == nullptr || tail->count == Capacity) linkAfter(tail);
+    insertAt(tail, tail->count, std::move(copy));
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::Prepend(const T& value) {
+    Insert(value, 0);
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::Insert(const T& value, std::size_t index) {
+    if (index > size) {
+        throw std::out_of_range("Index out of range");
+    }
+    T copy(value);
+    if (root == nullptr) {
+        linkAfter(nullptr);
+        insertAt(root, 0, std::move(copy));
+        return;
+    }
+    std::size_t start;
+    NodeType* n = nodeFor(index, start);
+    // A full end node gets a fresh neighbour instead of being split, so
+    // repeated Prepend fills nodes completely as Append does.
+    if (n->count == Capacity && index == 0) {
+        n = linkAfter(nullptr);
+    } else if (n->count == Capacity && index == size) {
+        n = linkAfter(n);
+        start = size;
+    } else if (n->count == Capacity) {
+        split(n);
+        if (index - start > n->count) {
+            start += n->count;
+            n = n->next;
+        }
+    }
+    insertAt(n, index - start, std::move(copy));
+    cursor = n;
+    cursorStart = start;
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::Remove(std::size_t index) {
+    if (index >= size) {
+        throw std::out_of_range("Index out of range");
+    }
+    std::size_t start;
+    NodeType* n = nodeFor(index, start);
+    T* items = n->items();
+    for (std::size_t i = index - start; i + 1 < n->count; ++i) items[i] = std::move(items[i + 1]);
+    items[n->count - 1].~T();
+    --n->count;
+    --size;
+    if (n->count == 0) {
+        unlink(n);
+        return;
+    }
+    if (n->next && n->count + n->next->count <= Capacity / 2) mergeNext(n);
+    if (n->previous && n->previous->count + n->count <= Capacity / 2) {
+        start -= n->previous->count;
+        n = n->previous;
+        mergeNext(n);
+    }
+    cursor = n;
+    cursorStart = start;
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+T UnrolledLinkedList<T, Capacity, Alloc>::Get(std::size_t index) const {
+    if (index >= size) {
+        throw std::out_of_range("Index out of range");
+    }
+    std::size_t start;
+    NodeType* n = nodeFor(index, start);
+    return n->items()[index - start];
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+void UnrolledLinkedList<T, Capacity, Alloc>::CopyTo(std::size_t start, std::size_t count, T* out) const {
+    if (start > size || count > size - start) {
+        throw std::out_of_range("Index out of range");
+    }
+    if (count == 0) return;
+    std::size_t nodeStart;
+    NodeType* n = nodeFor(start, nodeStart);
+    std::size_t offset = start - nodeStart;
+    while (count > 0) {
+        std::size_t run = std::min(count, n->count - offset);
+        out = std::copy(n->items() + offset, n->items() + offset + run, out);
+        count -= run;
+        offset = 0;
+        n = n->next;
+    }
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+T UnrolledLinkedList<T, Capacity, Alloc>::GetFirst() const {
+    return Get(0);
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+T UnrolledLinkedList<T, Capacity, Alloc>::GetLast() const {
+    return Get(size - 1);
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+UnrolledLinkedList<T, Capacity, Alloc>* UnrolledLinkedList<T, Capacity, Alloc>::Concat(const UnrolledLinkedList& list) {
+    auto* result = new UnrolledLinkedList(*this);
+    for (NodeType* n = list.root; n != nullptr; n = n->next)
+        for (std::size_t i = 0; i < n->count; ++i) result->Append(n->items()[i]);
+    return result;
+}
+
+template <typename T, std::size_t Capacity, typename Alloc>
+UnrolledLinkedList<T, Capacity, Alloc>* UnrolledLinkedList<T, Capacity, Alloc>::GetSublist(std::size_t startIndex, std::size_t endIndex) {
+    if (startIndex >= size || endIndex >= size || startIndex > endIndex) {
+        throw std::out_of_range("Index out of range");
+    }
+    auto* result = new UnrolledLinkedList(static_cast<const Alloc&>(*this));
+    std::size_t nodeStart;
+    NodeType* n = nodeFor(startIndex, nodeStart);
+    std::size_t offset = startIndex - nodeStart;
+    for (std::size_t i = startIndex; i <= endIndex; ++i, ++offset) {
+        if (offset == n->count) {
+            n = n->next;
+            offset = 0;
+        }
+        result->Append(n->items()[offset]);
+    }
+    return result;
+}
+
+#endif
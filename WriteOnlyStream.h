@@ -6,6 +6,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstddef>
 
 #include "DynamicArray.h" 
 #include "SmartPointer.h" 
@@ -25,8 +26,8 @@ class WriteOnlyStream {
 private:
     struct IStreamImpl {
         virtual ~IStreamImpl() = default;
-        virtual int Write(const T& value) = 0; 
-        virtual int GetPosition() const = 0; 
+        virtual std::size_t Write(const T& value) = 0; 
+        virtual std::size_t GetPosition() const = 0; 
         virtual void Reset() = 0; 
     };
 
@@ -37,12 +38,12 @@ private:
             if (!array_ptr) throw std::invalid_argument("WriteOnlyStream: DynamicArray is null");
         }
         
-        int Write(const T& value) override {
+        std::size_t Write(const T& value) override {
             array_ptr->Append(value);
             return array_ptr->GetSize(); 
         }
         
-        int GetPosition() const override {
+        std::size_t GetPosition() const override {
             return array_ptr->GetSize();
         }
         
@@ -55,7 +56,7 @@ private:
         std::ostream* stream;
         UniquePtr<std::ostream> ownedStream;
         Serializer<T> serializer;
-        int pos; 
+        std::size_t pos; 
         
     public:
         IoStreamImpl(std::ostream* strm, Serializer<T> ser) 
@@ -63,7 +64,7 @@ private:
             if (!stream) throw std::invalid_argument("Stream is null");
         }
 
-        int Write(const T& value) override {
+        std::size_t Write(const T& value) override {
             std::string serialized = serializer(value);
             (*stream) << serialized << "\n";
             if (stream->fail()) {
@@ -73,7 +74,7 @@ private:
             return pos;
         }
 
-        int GetPosition() const override { return pos; }
+        std::size_t GetPosition() const override { return pos; }
         void Reset() override { stream->clear(); pos = 0; }
     };
 
@@ -89,7 +90,7 @@ public:
         : impl(new IoStreamImpl(stream, ser)), isOpen(true) {}
 
 
-    int Write(const T& value) {
+    std::size_t Write(const T& value) {
         if (!isOpen) throw std::logic_error("Stream is closed");
         return impl->Write(value);
     }
@@ -2,6 +2,8 @@
 #include <string>
 #include <stdexcept>
 #include <clocale>
+#include <cstdio>
+#include <filesystem>
 #include "MutableArraySequence.h"
 #include "ImmutableArraySequence.h"
 #include "LinkedSequenceMutable.h"
@@ -9,7 +11,16 @@
 #include "Stack.h"
 #include "Queue.h"
 #include "Deck.h"
+#include "RingDeque.h"
+#include "RingQueue.h"
+#include "RingStack.h"
+#include "SmallDynamicArray.h"
+#include "BackedArraySequence.h"
+#include "SequenceView.h"
+#include "MPMCQueue.h"
 #include <cassert>
+#include <thread>
+#include <vector>
 void RunDequeTests() {
     Deque<double> dq;
 
@@ -98,9 +109,581 @@ void RunStackTests() {
 
     std::cout << "Stack tests PASS\n";
 }
+void RunRingBufferTests() {
+    RingDeque<int> ring;
+    Deque<int> linked;
+    assert(ring.GetSize() == 0);
+    // Mixed pushes and pops at both ends keep head wrapping around the buffer.
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 3 == 0) { ring.PushFront(i); linked.PushFront(i); }
+        else { ring.PushTop(i); linked.PushTop(i); }
+        if (i % 5 == 4) {
+            int front = ring.PopFront();
+            int expected = linked.PopFront();
+            assert(front == expected);
+        }
+        if (i % 7 == 6) {
+            int top = ring.PopTop();
+            int expected = linked.PopTop();
+            assert(top == expected);
+        }
+    }
+    assert(ring.GetSize() == linked.GetSize());
+    for (std::size_t i = 0; i < ring.GetSize(); ++i) assert(ring.Get(i) == linked.Get(i));
+    assert(ring.Front() == linked.Front() && ring.Top() == linked.Top());
+
+    RingDeque<int> copy(ring);
+    ring.Clear();
+    assert(ring.GetSize() == 0 && copy.GetSize() == linked.GetSize());
+    assert(copy.Get(0) == linked.Get(0));
+    try {
+        ring.PopTop();
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+    try {
+        copy.Get(copy.GetSize());
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+
+    RingBuffer<std::string> words;
+    assert(words.GetCapacity() == 0);
+    for (int i = 0; i < 20; ++i) words.PushBack(std::to_string(i));
+    assert(words.GetCapacity() == 32);
+    words.PushFront(words.Get(19));
+    assert(words.Front() == "19" && words.Back() == "19" && words.GetSize() == 21);
+
+    RingQueue<std::string> q;
+    for (int i = 0; i < 100; ++i) {
+        q.Push(std::to_string(i));
+        if (i % 2) {
+            std::string front = q.Pop();
+            assert(front == std::to_string(i / 2));
+        }
+    }
+    assert(q.GetSize() == 50 && q.Front() == "50");
+
+    RingStack<int> st;
+    for (int i = 0; i < 100; ++i) st.Push(i);
+    assert(st.Top() == 99);
+    int top = st.Pop();
+    assert(top == 99 && st.GetSize() == 99);
+    st.Clear();
+    try {
+        st.Pop();
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+
+    std::cout << "Ring buffer tests PASS\n";
+}
+// Counts default constructions and copy assignments: the old Append and
+// Insert default-constructed a slot and then copy-assigned into it.
+struct AssignCounted {
+    static int defaults;
+    static int assignments;
+    int value;
+    AssignCounted() : value(0) { ++defaults; }
+    AssignCounted(int v) : value(v) {}
+    AssignCounted(const AssignCounted&) = default;
+    AssignCounted(AssignCounted&&) = default;
+    AssignCounted& operator=(const AssignCounted& other) { value = other.value; ++assignments; return *this; }
+    AssignCounted& operator=(AssignCounted&&) = default;
+};
+int AssignCounted::defaults = 0;
+int AssignCounted::assignments = 0;
+
+void RunDynamicArrayTests() {
+    DynamicArray<int> arr;
+    for (int i = 0; i < 100; ++i) arr.Append(i);
+    assert(arr.GetSize() == 100);
+    assert(arr.Get(99) == 99);
+
+    // An index past 2^32 used to wrap to a small int.
+    try {
+        arr.Get((size_t(1) << 32) + 5);
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+
+    try {
+        arr.Reserve(DynamicArray<int>::MaxSize() + 1);
+        assert(false);
+    } catch (const std::length_error&) {
+    }
+    assert(arr.GetSize() == 100);
+
+    DynamicArray<std::string> words;
+    words.Insert(0, "c");
+    words.Insert(0, "a");
+    words.Insert(1, "b");
+    words.Insert(3, "d");
+    words.Insert(0, words.Get(3));
+    assert(words.GetSize() == 5 && words.Get(0) == "d" && words.Get(1) == "a" && words.Get(2) == "b" && words.Get(4) == "d");
+    try {
+        words.Insert(6, "x");
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+
+    arr.Insert(50, -1);
+    assert(arr.GetSize() == 101 && arr.Get(49) == 49 && arr.Get(50) == -1 && arr.Get(51) == 50 && arr.Get(100) == 99);
+
+    MutableArraySequence<AssignCounted> seq;
+    for (int i = 0; i < 20; ++i) seq.Append(AssignCounted(i));
+    seq.Prepend(AssignCounted(-1));
+    seq.Insert(AssignCounted(-2), 10);
+    assert(AssignCounted::defaults == 0 && AssignCounted::assignments == 0);
+    assert(seq.GetLength() == 22 && seq.Get(0).value == -1 && seq.Get(10).value == -2 && seq.Get(11).value == 9 && seq.Get(21).value == 19);
+
+    std::cout << "DynamicArray tests PASS\n";
+}
+void RunSmallDynamicArrayTests() {
+    SmallDynamicArray<std::string, 2> arr;
+    arr.Append("a");
+    arr.Append("b");
+    assert(arr.IsInline());
+    arr.Append("c");
+    assert(!arr.IsInline() && arr.GetSize() == 3 && arr.Get(0) == "a" && arr.Get(2) == "c");
+
+    SmallDynamicArray<std::string, 2> small;
+    small.Append("x");
+    SmallDynamicArray<std::string, 2> moved(std::move(small));
+    assert(moved.IsInline() && moved.GetSize() == 1 && moved.Get(0) == "x" && small.GetSize() == 0);
+
+    moved = arr;
+    assert(moved == arr);
+    arr = SmallDynamicArray<std::string, 2>();
+    assert(arr.GetSize() == 0 && arr.IsInline());
+
+    SmallDynamicArray<std::string, 2> letters;
+    letters.Insert(0, "b");
+    letters.Insert(0, "a");
+    letters.Insert(1, letters.Get(1));
+    assert(!letters.IsInline() && letters.GetSize() == 3 && letters.Get(0) == "a" && letters.Get(1) == "b" && letters.Get(2) == "b");
+
+    std::cout << "SmallDynamicArray tests PASS\n";
+}
+// Counts copy and move constructions, i.e. how often a container relocates.
+struct CountedCopy {
+    static int constructions;
+    int value;
+    CountedCopy(int v = 0) : value(v) {}
+    CountedCopy(const CountedCopy& other) : value(other.value) { ++constructions; }
+    CountedCopy(CountedCopy&& other) noexcept : value(other.value) { ++constructions; }
+    CountedCopy& operator=(const CountedCopy&) = default;
+    bool operator!=(const CountedCopy& other) const { return value != other.value; }
+};
+int CountedCopy::constructions = 0;
+
+void RunSegmentedArrayTests() {
+    SegmentedArray<CountedCopy, 4> arr;
+    arr.Append(CountedCopy(0));
+    const CountedCopy* first = &arr.Get(0);
+    CountedCopy::constructions = 0;
+    for (int i = 1; i < 1000; ++i) arr.Append(CountedCopy(i));
+    assert(CountedCopy::constructions == 999);
+    assert(&arr.Get(0) == first);
+    assert(arr.GetBlockCount() == 250 && arr.Get(999).value == 999);
+    arr.Resize(5);
+    assert(arr.GetBlockCount() == 2 && arr.Get(4).value == 4);
+
+    SegmentedArraySequence<int> seq;
+    for (int i = 0; i < 600; ++i) seq.Append(i);
+    const int* head = &seq.At(0);
+    seq.Insert(-1, 1);
+    seq.Prepend(-2);
+    assert(seq.GetLength() == 602 && seq.Get(0) == -2 && seq.Get(2) == -1 && seq.GetLast() == 599);
+    assert(&seq.At(0) == head);
+    Sequence<int>* sub = seq.GetSubsequence(2, 4);
+    assert(sub->GetLength() == 3 && sub->Get(0) == -1 && sub->Get(2) == 2);
+    delete sub;
+
+    std::cout << "SegmentedArray tests PASS\n";
+}
+void RunMappedDynamicArrayTests() {
+    std::string path = (std::filesystem::temp_directory_path() / "mapped_array_test.bin").string();
+    std::remove(path.c_str());
+    {
+        MappedDynamicArray<long long> prefix(path);
+        for (long long i = 0; i < 100000; ++i) prefix.Append(i * i);
+        prefix.Flush();
+    }
+    {
+        MappedDynamicArray<long long> reopened(path);
+        assert(reopened.GetSize() == 100000 && reopened.Get(99999) == 99999LL * 99999LL);
+        MappedDynamicArray<long long> copy(reopened);
+        copy.Set(0, -1);
+        assert(copy.GetSize() == reopened.GetSize() && reopened.Get(0) == 0);
+    }
+    try {
+        MappedDynamicArray<int> wrongType(path);
+        assert(false);
+    } catch (const std::runtime_error&) {
+    }
+    std::remove(path.c_str());
+
+    MappedArraySequence<int> seq;
+    for (int i = 0; i < 5000; ++i) seq.Append(i);
+    seq.Prepend(-1);
+    assert(seq.GetLength() == 5001 && seq.GetFirst() == -1 && seq.GetLast() == 4999);
+
+    std::cout << "MappedDynamicArray tests PASS\n";
+}
+void RunSequenceViewTests() {
+    int items[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    SharedPtr< MutableArraySequence<int> > seq = MakeShared< MutableArraySequence<int> >(items, 10);
+
+    SequenceView<int> view = GetSubsequenceView(seq, 2, 7);
+    assert(view.GetLength() == 6 && view.GetFirst() == 2 && view.GetLast() == 7);
+    SequenceView<int> inner = view.GetSubview(1, 3);
+    assert(inner.GetOffset() == 3 && inner.Get(2) == 5);
+
+    // The view owns its source, so it survives the last other owner.
+    seq.reset();
+    assert(view.Get(0) == 2 && view.GetSource().use_count() == 2);
+
+    Sequence<int>* extended = view.Append(100);
+    assert(extended->GetLength() == 7 && extended->GetLast() == 100 && view.GetLength() == 6);
+    delete extended;
+
+    try {
+        view.GetSubview(4, 6);
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+
+    // GetSubsequence still copies, but only the requested range.
+    MutableArraySequence<int> source(items, 10);
+    Sequence<int>* copied = source.GetSubsequence(3, 5);
+    assert(copied->GetLength() == 3 && copied->Get(0) == 3 && copied->Get(2) == 5);
+    assert(dynamic_cast<MutableArraySequence<int>*>(copied) != nullptr);
+    delete copied;
+
+    std::cout << "SequenceView tests PASS\n";
+}
+void RunCopyRangeTests() {
+    int items[] = {1, 2, 3, 4, 5, 6};
+    MutableArraySequence<int> array(items, 6);
+    LinkedSequenceMutable<int> linked(items, 6);
+    SegmentedArraySequence<int> segmented(items, 6);
+
+    Sequence<int>* sources[] = { &array, &linked, &segmented };
+    for (Sequence<int>* seq : sources) {
+        int out[3] = {0, 0, 0};
+        seq->CopyRange(2, 3, out);
+        assert(out[0] == 3 && out[1] == 4 && out[2] == 5);
+        try {
+            seq->CopyRange(4, 3, out);
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+    }
+
+    Sequence<int>* joined = array.Concat(&linked);
+    assert(joined->GetLength() == 12 && joined->Get(6) == 1 && joined->GetLast() == 6);
+    delete joined;
+    joined = linked.Concat(&segmented);
+    assert(joined->GetLength() == 12 && joined->Get(11) == 6);
+    delete joined;
+
+    std::cout << "CopyRange tests PASS\n";
+}
+// Random inserts/removes/reads checked against a plain array, so the tail
+// pointer and the lookup cursor are exercised at every position.
+void RunLinkedListCursorTests() {
+    LinkedList<int> list;
+    DynamicArray<int> model;
+    unsigned state = 12345;
+    auto next = [&state]() { state = state * 1103515245u + 12345u; return (state >> 16) & 0x7fff; };
+    for (int step = 0; step < 20000; ++step) {
+        std::size_t n = model.GetSize();
+        unsigned op = next() % 6;
+        if (op == 0 || n == 0) {
+            list.Append(step);
+            model.Append(step);
+        } else if (op == 1) {
+            std::size_t at = next() % (n + 1);
+            list.Insert(step, at);
+            model.Append(0);
+            for (std::size_t i = n; i > at; --i) model.Set(i, model.Get(i - 1));
+            model.Set(at, step);
+        } else if (op == 2) {
+            std::size_t at = next() % n;
+            list.Remove(at);
+            for (std::size_t i = at; i + 1 < n; ++i) model.Set(i, model.Get(i + 1));
+            model.Resize(n - 1);
+        } else {
+            std::size_t at = next() % n;
+            assert(list.Get(at) == model.Get(at));
+            if (at + 1 < n) assert(list.Get(at + 1) == model.Get(at + 1));
+        }
+        assert(list.GetLength() == model.GetSize());
+    }
+    for (std::size_t i = 0; i < model.GetSize(); ++i) assert(list.Get(i) == model.Get(i));
+    if (model.GetSize() > 0) assert(list.GetLast() == model.Get(model.GetSize() - 1));
+
+    std::cout << "LinkedList cursor tests PASS\n";
+}
+void RunUnrolledLinkedListTests() {
+    // Capacity 4 so that inserts split and removals merge nodes constantly.
+    UnrolledLinkedList<std::string, 4> unrolled;
+    LinkedList<std::string> model;
+    unsigned state = 12345;
+    for (int step = 0; step < 4000; ++step) {
+        state = state * 1103515245u + 12345u;
+        std::size_t length = model.GetLength();
+        std::size_t at = length ? (state >> 8) % (length + 1) : 0;
+        std::string value = std::to_string(step);
+        if (length > 0 && (state >> 4) % 5 < 2) {
+            if (at == length) at = length - 1;
+            unrolled.Remove(at);
+            model.Remove(at);
+        } else if ((state >> 4) % 5 == 2) {
+            unrolled.Prepend(value);
+            model.Prepend(value);
+        } else {
+            unrolled.Insert(value, at);
+            model.Insert(value, at);
+        }
+        assert(unrolled.GetLength() == model.GetLength());
+        if (step % 97 == 0) {
+            for (std::size_t i = 0; i < model.GetLength(); ++i) assert(unrolled.Get(i) == model.Get(i));
+        }
+    }
+    std::size_t length = unrolled.GetLength();
+    // Any two neighbouring nodes hold at least 3 elements.
+    assert(3 * unrolled.GetNodeCount() <= 2 * length + 3);
+    for (std::size_t i = length; i > 0; --i) assert(unrolled.Get(i - 1) == model.Get(i - 1));
+
+    DynamicArray<std::string> out(length);
+    unrolled.CopyTo(0, length, &out.Get(0));
+    for (std::size_t i = 0; i < length; ++i) assert(out.Get(i) == model.Get(i));
+
+    UnrolledLinkedList<std::string, 4>* sub = unrolled.GetSublist(3, 10);
+    assert(sub->GetLength() == 8 && sub->GetFirst() == model.Get(3) && sub->GetLast() == model.Get(10));
+    delete sub;
+
+    UnrolledLinkedList<std::string, 4> copy;
+    copy = unrolled;
+    // Each pooled list owns its nodes, so assignment must not adopt another
+    // list's (or a temporary's) nodes.
+    UnrolledLinkedList<std::string, 4, NodePool> pooled, assigned;
+    for (int i = 0; i < 20; ++i) pooled.Append(std::to_string(i));
+    assigned.Append("old");
+    assigned.Get(0);
+    assigned = pooled;
+    assert(assigned.GetLength() == 20 && assigned.Get(7) == "7" && assigned.GetLast() == "19");
+    assigned = assigned;
+    pooled.Remove(0);
+    assert(assigned.GetFirst() == "0");
+    while (unrolled.GetLength() > 0) unrolled.Remove(0);
+    assert(unrolled.GetNodeCount() == 0 && copy.GetLength() == length);
+    try {
+        unrolled.GetFirst();
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+
+    int items[] = {1, 2, 3, 4, 5};
+    UnrolledLinkedSequenceMutable<int> seq(items, 5);
+    seq.Insert(10, 2)->Append(6);
+    assert(seq.GetLength() == 7 && seq.Get(2) == 10 && seq.GetLast() == 6);
+    Sequence<int>* part = seq.GetSubsequence(1, 3);
+    assert(part->GetLength() == 3 && part->Get(0) == 2 && part->Get(2) == 3);
+    delete part;
+
+    UnrolledLinkedSequenceImmutable<int> frozen(items, 5);
+    Sequence<int>* grown = frozen.Prepend(0);
+    assert(frozen.GetLength() == 5 && grown->GetLength() == 6 && grown->GetFirst() == 0);
+    delete grown;
+
+    std::cout << "Unrolled linked list tests PASS\n";
+}
+void RunNodePoolTests() {
+    LinkedList<std::string> list;
+    for (int i = 0; i < 1000; ++i) list.Append(std::to_string(i));
+
+    for (int i = 0; i < 500; ++i) list.Remove(0);
+    for (int i = 0; i < 500; ++i) list.Prepend("x");
+    assert(list.GetLength() == 1000 && list.GetFirst() == "x" && list.GetLast() == "999");
+
+    LinkedList<std::string> copy(list);
+    list.Clear();
+    assert(list.GetLength() == 0);
+    assert(copy.GetLength() == 1000 && copy.Get(500) == "500");
+    list.Append("again");
+    assert(list.GetFirst() == "again" && list.GetLast() == "again");
+
+    // Each list frees its nodes into its own pool, so assignment must not
+    // share them.
+    LinkedList<std::string> assigned;
+    assigned.Append("old");
+    assigned = copy;
+    copy.Clear();
+    assert(assigned.GetLength() == 1000 && assigned.Get(500) == "500" && assigned.GetLast() == "999");
+    assigned = assigned;
+    assert(assigned.GetLength() == 1000 && assigned.GetFirst() == "x");
+
+    NodePool pool;
+    void* a = pool.allocate(24, 8);
+    void* b = pool.allocate(24, 8);
+    pool.deallocate(a, 24, 8);
+    void* reused = pool.allocate(24, 8);
+    assert(reused == a);
+    void* big = pool.allocate(100, 8);
+    assert(pool.slab_count() == 1);
+    pool.deallocate(big, 100, 8);
+    pool.deallocate(b, 24, 8);
+    pool.deallocate(reused, 24, 8);
+    // Slabs double from 16 blocks: 16 + 32 + ... + 512 covers 1000.
+    for (int i = 0; i < 1000; ++i) pool.allocate(24, 8);
+    assert(pool.slab_count() == 6);
+    pool.release();
+    assert(pool.slab_count() == 0);
+
+    Deque<std::string> dq;
+    for (int i = 0; i < 100; ++i) dq.PushTop(std::to_string(i));
+    dq.Clear();
+    assert(dq.GetSize() == 0);
+    dq.PushFront("a");
+    assert(dq.Front() == "a" && dq.GetSize() == 1);
+
+    Queue<int> q;
+    for (int i = 0; i < 100; ++i) q.Push(i);
+    q.Clear();
+    q.Push(7);
+    assert(q.GetSize() == 1 && q.Front() == 7);
+
+    std::cout << "Node pool tests PASS\n";
+}
+void RunMPMCQueueTests() {
+    MPMCQueue<std::string> q(5);
+    assert(q.GetCapacity() == 8);
+    std::string out;
+    bool ok = q.TryPop(out);
+    assert(!ok);
+    // Several laps around the ring.
+    for (int lap = 0; lap < 5; ++lap) {
+        for (int i = 0; i < 8; ++i) {
+            ok = q.TryPush(std::to_string(lap * 8 + i));
+            assert(ok);
+        }
+        ok = q.TryPush("overflow");
+        assert(!ok && q.GetSize() == 8);
+        for (int i = 0; i < 8; ++i) {
+            ok = q.TryPop(out);
+            assert(ok && out == std::to_string(lap * 8 + i));
+        }
+        ok = q.TryPop(out);
+        assert(!ok);
+    }
+    q.TryPush("left behind");
+
+    try {
+        MPMCQueue<int> none(0);
+        assert(false);
+    } catch (const std::invalid_argument&) {
+    }
+
+    // Items are (producer << 32 | sequence); each consumer must see every
+    // producer's items in increasing order, and all of them exactly once.
+    const int producers = 4, consumers = 4, perProducer = 20000;
+    BlockingMPMCQueue<long long> work(64);
+    std::vector<long long> sums(consumers, 0), counts(consumers, 0);
+    std::vector<int> ordered(consumers, 1);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            long long last[producers];
+            for (int p = 0; p < producers; ++p) last[p] = -1;
+            long long item;
+            while (work.Pop(item)) {
+                int p = (int)(item >> 32);
+                long long seq = item & 0xffffffff;
+                if (seq <= last[p]) ordered[c] = 0;
+                last[p] = seq;
+                sums[c] += seq;
+                ++counts[c];
+            }
+        });
+    }
+    std::vector<std::thread> pushers;
+    for (int p = 0; p < producers; ++p) {
+        pushers.emplace_back([&, p] {
+            for (long long i = 0; i < perProducer; ++i) {
+                bool pushed = work.Push(((long long)p << 32) | i);
+                assert(pushed);
+            }
+        });
+    }
+    for (std::thread& t : pushers) t.join();
+    work.Close();
+    ok = work.Push(1);
+    assert(!ok);
+    for (std::thread& t : threads) t.join();
+
+    long long sum = 0, count = 0;
+    for (int c = 0; c < consumers; ++c) {
+        assert(ordered[c]);
+        sum += sums[c];
+        count += counts[c];
+    }
+    assert(count == (long long)producers * perProducer);
+    assert(sum == (long long)producers * perProducer * (perProducer - 1) / 2);
+
+    std::cout << "MPMC queue tests PASS\n";
+}
+void RunArenaAllocatorTests() {
+    Arena arena(1024);
+    {
+        DynamicArray<int, ArenaAllocator> cache{ArenaAllocator(arena)};
+        for (int i = 0; i < 1000; ++i) cache.Append(i * i);
+        assert(cache.GetSize() == 1000);
+        assert(cache.Get(999) == 999 * 999);
+
+        DynamicArray<std::string, ArenaAllocator> names{ArenaAllocator(arena)};
+        for (int i = 0; i < 50; ++i) names.Append(std::to_string(i));
+        DynamicArray<std::string, ArenaAllocator> copy(names);
+        assert(copy == names);
+
+        // Only the spill past the inline buffer comes from the arena.
+        std::size_t before = arena.bytes_used();
+        SmallDynamicArray<int, 4, ArenaAllocator> small{ArenaAllocator(arena)};
+        for (int i = 0; i < 4; ++i) small.Append(i);
+        assert(small.IsInline() && arena.bytes_used() == before);
+        small.Append(4);
+        assert(!small.IsInline() && arena.bytes_used() > before && small.Get(4) == 4);
+
+        LinkedList<int, ArenaAllocator> list{ArenaAllocator(arena)};
+        for (int i = 0; i < 100; ++i) list.Append(i);
+        list.Remove(0);
+        LinkedList<int, ArenaAllocator>* tail = list.GetSublist(10, 19);
+        assert(tail->GetLength() == 10 && tail->GetFirst() == 11);
+        delete tail;
+    }
+    assert(arena.bytes_used() > 0);
+    arena.release();
+    assert(arena.bytes_used() == 0);
+
+    std::cout << "Arena allocator tests PASS\n";
+}
 int main() {
     RunDequeTests();
     RunQueueTests();
     RunStackTests();
+    RunRingBufferTests();
+    RunDynamicArrayTests();
+    RunSmallDynamicArrayTests();
+    RunSegmentedArrayTests();
+    RunMappedDynamicArrayTests();
+    RunSequenceViewTests();
+    RunCopyRangeTests();
+    RunLinkedListCursorTests();
+    RunUnrolledLinkedListTests();
+    RunNodePoolTests();
+    RunMPMCQueueTests();
+    RunArenaAllocatorTests();
     return 0;
 }
@@ -0,0 +1,561 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "DynamicArray.h"
+#include "MutableArraySequence.h"
+#include "BackedArraySequence.h"
+#include "SequenceView.h"
+#include "LinkedSequenceMutable.h"
+#include "Queue.h"
+#include "Stack.h"
+#include "Deck.h"
+#include "RingQueue.h"
+#include "RingStack.h"
+#include "RingDeque.h"
+#include "MPMCQueue.h"
+#include "TuringMachine.h"
+
+using namespace std;
+using namespace std::chrono;
+
+
+// DynamicArray as it was before it switched to raw storage: every slot is
+// value-initialised on allocation and growth copy-assigns each element.
+// Kept here only as the benchmark baseline.
+template <typename T>
+class LegacyDynamicArray {
+public:
+    LegacyDynamicArray() : size(0), capacity(1), data(new T[1]()) {}
+    ~LegacyDynamicArray() { delete[] data; }
+
+    void Append(const T& value) {
+        if (size >= capacity) {
+            int newCap = capacity * 2;
+            T* newData = new T[newCap]();
+            for (int i = 0; i < size; ++i) newData[i] = data[i];
+            delete[] data;
+            data = newData;
+            capacity = newCap;
+        }
+        data[size++] = value;
+    }
+    int GetSize() const { return size; }
+
+private:
+    int size;
+    int capacity;
+    T* data;
+};
+
+static volatile int benchmark_sink;
+
+
+TMState MakeBenchmarkState(int tapeLength, int step) {
+    TuringTape tape('_');
+    tape.LoadFromString(string(tapeLength, 'a' + step % 26));
+    return TMState(tape, step % 7, step);
+}
+
+// Appends n states (each with a tapeLength-cell tape) to an empty array.
+void benchmark_tmstate_growth(int n, int tapeLength, ofstream& out) {
+    TMState proto = MakeBenchmarkState(tapeLength, 0);
+
+    auto start = high_resolution_clock::now();
+    {
+        LegacyDynamicArray<TMState> arr;
+        for (int i = 0; i < n; ++i) arr.Append(proto);
+        benchmark_sink = arr.GetSize();
+    }
+    auto end = high_resolution_clock::now();
+    auto legacy_time = duration_cast<microseconds>(end - start).count();
+
+    start = high_resolution_clock::now();
+    {
+        DynamicArray<TMState> arr;
+        for (int i = 0; i < n; ++i) arr.Append(proto);
+        benchmark_sink = arr.GetSize();
+    }
+    end = high_resolution_clock::now();
+    auto copy_time = duration_cast<microseconds>(end - start).count();
+
+    start = high_resolution_clock::now();
+    {
+        DynamicArray<TMState> arr;
+        for (int i = 0; i < n; ++i) arr.Append(TMState(proto));
+        benchmark_sink = arr.GetSize();
+    }
+    end = high_resolution_clock::now();
+    auto move_time = duration_cast<microseconds>(end - start).count();
+
+    cout << "n=" << n << " tape=" << tapeLength
+         << " | legacy: " << legacy_time << "us"
+         << " | append(const&): " << copy_time << "us"
+         << " | append(&&): " << move_time << "us\n";
+    out << n << "," << tapeLength << "," << legacy_time << "," << copy_time << "," << move_time << "\n";
+}
+
+
+// A char that is not trivially copyable, so DynamicArray takes its generic
+// element-by-element path; the baseline for the bulk path on plain char.
+struct OpaqueChar {
+    char c;
+    OpaqueChar(char v = 0) : c(v) {}
+    OpaqueChar(const OpaqueChar& other) : c(other.c) {}
+    OpaqueChar& operator=(const OpaqueChar& other) { c = other.c; return *this; }
+    bool operator!=(const OpaqueChar& other) const { return c != other.c; }
+};
+
+// Grows a tape of n cells by Append, then copies it and compares the copy
+// (what TuringTape does for every TMState and every operator==).
+template <typename Cell>
+long long tape_round_trip(int n, int copies) {
+    auto start = high_resolution_clock::now();
+    DynamicArray<Cell> tape;
+    for (int i = 0; i < n; ++i) tape.Append(Cell('a' + i % 26));
+    int equal = 0;
+    for (int k = 0; k < copies; ++k) {
+        DynamicArray<Cell> copy(tape);
+        equal += (copy == tape);
+    }
+    benchmark_sink = equal;
+    auto end = high_resolution_clock::now();
+    return duration_cast<microseconds>(end - start).count();
+}
+
+void benchmark_trivial_tape(int n, ofstream& out) {
+    const int copies = 16;
+    auto generic_time = tape_round_trip<OpaqueChar>(n, copies);
+    auto bulk_time = tape_round_trip<char>(n, copies);
+    cout << "tape=" << n << " | generic: " << generic_time << "us | bulk: " << bulk_time << "us\n";
+    out << n << "," << generic_time << "," << bulk_time << "\n";
+}
+
+
+// Counts every element copy, whether by construction or assignment.
+struct CopyCounted {
+    static long long copies;
+    long long value;
+    CopyCounted(long long v = 0) : value(v) {}
+    CopyCounted(const CopyCounted& other) : value(other.value) { ++copies; }
+    CopyCounted& operator=(const CopyCounted& other) { value = other.value; ++copies; return *this; }
+};
+long long CopyCounted::copies = 0;
+
+// Memoises n elements one Append at a time, as a generator does, and
+// reports time plus the element copies beyond the one per Append.
+template <typename Store>
+long long materialise(int n, long long& extraCopies) {
+    CopyCounted::copies = 0;
+    auto start = high_resolution_clock::now();
+    {
+        Store cache;
+        for (int i = 0; i < n; ++i) cache.Append(CopyCounted(i));
+        benchmark_sink = (int)cache.GetLength();
+    }
+    auto end = high_resolution_clock::now();
+    extraCopies = CopyCounted::copies - n;
+    return duration_cast<microseconds>(end - start).count();
+}
+
+void benchmark_materialised_growth(int n, ofstream& out) {
+    long long arrayCopies = 0, segmentedCopies = 0;
+    auto array_time = materialise< MutableArraySequence<CopyCounted> >(n, arrayCopies);
+    auto segmented_time = materialise< SegmentedArraySequence<CopyCounted> >(n, segmentedCopies);
+    cout << "n=" << n << " | array: " << array_time << "us, " << arrayCopies << " extra copies"
+         << " | segmented: " << segmented_time << "us, " << segmentedCopies << " extra copies\n";
+    out << n << "," << array_time << "," << arrayCopies << "," << segmented_time << "," << segmentedCopies << "\n";
+}
+
+
+// Takes `slices` 16-element slices of an n-element sequence, first as
+// copying GetSubsequence results, then as SequenceViews.
+void benchmark_slices(int n, ofstream& out) {
+    const int slices = 10000;
+    const int width = 16;
+    SharedPtr< MutableArraySequence<int> > seq = MakeShared< MutableArraySequence<int> >();
+    for (int i = 0; i < n; ++i) seq->Append(i);
+
+    auto start = high_resolution_clock::now();
+    for (int k = 0; k < slices; ++k) {
+        size_t from = (size_t)k * 7919 % (n - width);
+        Sequence<int>* copy = seq->GetSubsequence(from, from + width - 1);
+        benchmark_sink = copy->Get(width - 1);
+        delete copy;
+    }
+    auto end = high_resolution_clock::now();
+    auto copy_time = duration_cast<microseconds>(end - start).count();
+
+    start = high_resolution_clock::now();
+    for (int k = 0; k < slices; ++k) {
+        size_t from = (size_t)k * 7919 % (n - width);
+        SequenceView<int> view = GetSubsequenceView(seq, from, from + width - 1);
+        benchmark_sink = view.Get(width - 1);
+    }
+    end = high_resolution_clock::now();
+    auto view_time = duration_cast<microseconds>(end - start).count();
+
+    cout << "n=" << n << " | " << slices << " slices: GetSubsequence " << copy_time << "us"
+         << " | GetSubsequenceView " << view_time << "us\n";
+    out << n << "," << copy_time << "," << view_time << "\n";
+}
+
+
+// n pushes then n pops on the list-backed Queue and Stack, and a
+// front-to-back Get(i) scan of an n-element LinkedSequence.
+void benchmark_linked(int n, ofstream& out) {
+    auto start = high_resolution_clock::now();
+    {
+        Queue<int> q;
+        for (int i = 0; i < n; ++i) q.Push(i);
+        long long sum = 0;
+        while (q.GetSize() > 0) sum += q.Pop();
+        benchmark_sink = (int)sum;
+    }
+    auto end = high_resolution_clock::now();
+    auto queue_time = duration_cast<microseconds>(end - start).count();
+
+    start = high_resolution_clock::now();
+    {
+        Stack<int> st;
+        for (int i = 0; i < n; ++i) st.Push(i);
+        long long sum = 0;
+        while (st.GetSize() > 0) sum += st.Pop();
+        benchmark_sink = (int)sum;
+    }
+    end = high_resolution_clock::now();
+    auto stack_time = duration_cast<microseconds>(end - start).count();
+
+    LinkedSequenceMutable<int> seq;
+    for (int i = 0; i < n; ++i) seq.Append(i);
+    start = high_resolution_clock::now();
+    {
+        long long sum = 0;
+        for (int i = 0; i < n; ++i) sum += seq.Get(i);
+        benchmark_sink = (int)sum;
+    }
+    end = high_resolution_clock::now();
+    auto scan_time = duration_cast<microseconds>(end - start).count();
+
+    cout << "n=" << n << " | queue push/pop: " << queue_time << "us | stack push/pop: " << stack_time
+         << "us | sequential Get scan: " << scan_time << "us\n";
+    out << n << "," << queue_time << "," << stack_time << "," << scan_time << "\n";
+}
+
+// Fill to n, cycle n more items through, then drain: the steady-state
+// pattern of a work queue.
+template <typename Q>
+long long time_queue(int n) {
+    auto start = high_resolution_clock::now();
+    Q q;
+    long long sum = 0;
+    for (int i = 0; i < n; ++i) q.Push(i);
+    for (int i = 0; i < n; ++i) {
+        sum += q.Pop();
+        q.Push(i);
+    }
+    while (q.GetSize() > 0) sum += q.Pop();
+    benchmark_sink = (int)sum;
+    return duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+}
+
+template <typename S>
+long long time_stack(int n) {
+    auto start = high_resolution_clock::now();
+    S st;
+    long long sum = 0;
+    for (int i = 0; i < n; ++i) st.Push(i);
+    for (int i = 0; i < n; ++i) {
+        sum += st.Pop();
+        st.Push(i);
+    }
+    while (st.GetSize() > 0) sum += st.Pop();
+    benchmark_sink = (int)sum;
+    return duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+}
+
+// Alternates ends, so the ring's head wraps in both directions.
+template <typename D>
+long long time_deque(int n) {
+    auto start = high_resolution_clock::now();
+    D dq;
+    long long sum = 0;
+    for (int i = 0; i < n; ++i) {
+        if (i & 1) dq.PushFront(i);
+        else dq.PushTop(i);
+    }
+    for (int i = 0; i < n; ++i) {
+        if (i & 1) {
+            sum += dq.PopTop();
+            dq.PushFront(i);
+        } else {
+            sum += dq.PopFront();
+            dq.PushTop(i);
+        }
+    }
+    while (dq.GetSize() > 0) sum += dq.PopFront();
+    benchmark_sink = (int)sum;
+    return duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+}
+
+void benchmark_ring(int n, ofstream& out) {
+    long long linked_queue = time_queue<Queue<int>>(n);
+    long long ring_queue = time_queue<RingQueue<int>>(n);
+    long long linked_stack = time_stack<Stack<int>>(n);
+    long long ring_stack = time_stack<RingStack<int>>(n);
+    long long linked_deque = time_deque<Deque<int>>(n);
+    long long ring_deque = time_deque<RingDeque<int>>(n);
+
+    cout << "n=" << n << " | queue linked/ring: " << linked_queue << "/" << ring_queue
+         << "us | stack linked/ring: " << linked_stack << "/" << ring_stack
+         << "us | deque linked/ring: " << linked_deque << "/" << ring_deque << "us\n";
+    out << n << "," << linked_queue << "," << ring_queue << "," << linked_stack << "," << ring_stack
+        << "," << linked_deque << "," << ring_deque << "\n";
+}
+
+template <typename Seq>
+void time_list_sequence(int n, long long& build, long long& scan, long long& copy, long long& insert) {
+    auto start = high_resolution_clock::now();
+    Seq seq;
+    for (int i = 0; i < n; ++i) seq.Append(i);
+    build = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    start = high_resolution_clock::now();
+    long long sum = 0;
+    for (int i = 0; i < n; ++i) sum += seq.Get(i);
+    benchmark_sink = (int)sum;
+    scan = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    DynamicArray<int> out(n);
+    start = high_resolution_clock::now();
+    seq.CopyRange(0, n, &out.Get(0));
+    benchmark_sink = out.Get(n - 1);
+    copy = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    // 1000 inserts at scattered positions.
+    unsigned state = 7;
+    start = high_resolution_clock::now();
+    for (int i = 0; i < 1000; ++i) {
+        state = state * 1103515245u + 12345u;
+        seq.Insert(i, (state >> 8) % seq.GetLength());
+    }
+    insert = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+}
+
+void benchmark_unrolled(int n, ofstream& out) {
+    long long linked_build, linked_scan, linked_copy, linked_insert;
+    long long unrolled_build, unrolled_scan, unrolled_copy, unrolled_insert;
+    time_list_sequence<LinkedSequenceMutable<int>>(n, linked_build, linked_scan, linked_copy, linked_insert);
+    time_list_sequence<UnrolledLinkedSequenceMutable<int>>(n, unrolled_build, unrolled_scan, unrolled_copy, unrolled_insert);
+
+    cout << "n=" << n << " | build linked/unrolled: " << linked_build << "/" << unrolled_build
+         << "us | Get scan: " << linked_scan << "/" << unrolled_scan
+         << "us | CopyRange: " << linked_copy << "/" << unrolled_copy
+         << "us | 1000 inserts: " << linked_insert << "/" << unrolled_insert << "us\n";
+    out << n << "," << linked_build << "," << unrolled_build << "," << linked_scan << "," << unrolled_scan
+        << "," << linked_copy << "," << unrolled_copy << "," << linked_insert << "," << unrolled_insert << "\n";
+}
+
+template <typename List>
+void time_list_nodes(int n, long long& build, long long& copy, long long& clear) {
+    auto start = high_resolution_clock::now();
+    List list;
+    for (int i = 0; i < n; ++i) list.Append(i);
+    build = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    start = high_resolution_clock::now();
+    List duplicate(list);
+    benchmark_sink = (int)duplicate.GetLength();
+    copy = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    start = high_resolution_clock::now();
+    list.Clear();
+    duplicate.Clear();
+    clear = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+}
+
+void benchmark_node_pool(int n, ofstream& out) {
+    long long heap_build, heap_copy, heap_clear;
+    long long pool_build, pool_copy, pool_clear;
+    time_list_nodes<LinkedList<int, HeapAllocator>>(n, heap_build, heap_copy, heap_clear);
+    time_list_nodes<LinkedList<int, NodePool>>(n, pool_build, pool_copy, pool_clear);
+
+    cout << "n=" << n << " | build heap/pool: " << heap_build << "/" << pool_build
+         << "us | copy: " << heap_copy << "/" << pool_copy
+         << "us | clear: " << heap_clear << "/" << pool_clear << "us\n";
+    out << n << "," << heap_build << "," << pool_build << "," << heap_copy << "," << pool_copy
+        << "," << heap_clear << "," << pool_clear << "\n";
+}
+
+// pairs producers and pairs consumers move items through one queue; the
+// baseline is the linked Queue behind a mutex, with consumers yielding when
+// it is empty.
+long long time_mutex_queue(int pairs, int items) {
+    Queue<int> q;
+    std::mutex lock;
+    int remaining = items;
+    auto start = high_resolution_clock::now();
+    vector<thread> threads;
+    for (int p = 0; p < pairs; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = p; i < items; i += pairs) {
+                std::lock_guard<std::mutex> guard(lock);
+                q.Push(i);
+            }
+        });
+    }
+    for (int c = 0; c < pairs; ++c) {
+        threads.emplace_back([&] {
+            long long sum = 0;
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (remaining == 0) break;
+                    if (q.GetSize() > 0) {
+                        sum += q.Pop();
+                        --remaining;
+                        continue;
+                    }
+                }
+                this_thread::yield();
+            }
+            benchmark_sink = (int)sum;
+        });
+    }
+    for (thread& t : threads) t.join();
+    return duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+}
+
+long long time_mpmc_queue(int pairs, int items) {
+    BlockingMPMCQueue<int> q(1024);
+    auto start = high_resolution_clock::now();
+    vector<thread> producers, consumers;
+    for (int p = 0; p < pairs; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = p; i < items; i += pairs) q.Push(i);
+        });
+    }
+    for (int c = 0; c < pairs; ++c) {
+        consumers.emplace_back([&] {
+            long long sum = 0;
+            int item;
+            while (q.Pop(item)) sum += item;
+            benchmark_sink = (int)sum;
+        });
+    }
+    for (thread& t : producers) t.join();
+    q.Close();
+    for (thread& t : consumers) t.join();
+    return duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+}
+
+void benchmark_mpmc(int pairs, int items, ofstream& out) {
+    long long mutex_time = time_mutex_queue(pairs, items);
+    long long mpmc_time = time_mpmc_queue(pairs, items);
+
+    cout << pairs << " producers + " << pairs << " consumers, " << items << " items | mutex Queue: " << mutex_time
+         << "us | MPMCQueue: " << mpmc_time << "us\n";
+    out << pairs << "," << mutex_time << "," << mpmc_time << "\n";
+}
+
+
+int main() {
+    ofstream out_growth("results_containers.csv");
+    out_growth << "size,tape,legacy,append_copy,append_move\n";
+    cout << "Running Benchmark: DynamicArray<TMState> growth...\n";
+
+    int sizes[] = { 1000, 10000, 100000, 1000000 };
+    for (int n : sizes) {
+        benchmark_tmstate_growth(n, 64, out_growth);
+    }
+    out_growth.close();
+    cout << "---------------------------\n";
+
+    ofstream out_tape("results_tape.csv");
+    out_tape << "size,generic,bulk\n";
+    cout << "Running Benchmark: DynamicArray<char> tape growth/copy/compare...\n";
+
+    int tape_sizes[] = { 1000, 100000, 1000000, 10000000 };
+    for (int n : tape_sizes) {
+        benchmark_trivial_tape(n, out_tape);
+    }
+    out_tape.close();
+    cout << "---------------------------\n";
+
+    ofstream out_materialised("results_materialised.csv");
+    out_materialised << "size,array,array_extra_copies,segmented,segmented_extra_copies\n";
+    cout << "Running Benchmark: memoised prefix growth (ArraySequence vs SegmentedArraySequence)...\n";
+
+    for (int n : sizes) {
+        benchmark_materialised_growth(n, out_materialised);
+    }
+    out_materialised.close();
+    cout << "---------------------------\n";
+
+    ofstream out_slices("results_slices.csv");
+    out_slices << "size,subsequence,view\n";
+    cout << "Running Benchmark: GetSubsequence vs GetSubsequenceView...\n";
+
+    for (int n : sizes) {
+        benchmark_slices(n, out_slices);
+    }
+    out_slices.close();
+    cout << "---------------------------\n";
+
+    ofstream out_linked("results_linked.csv");
+    out_linked << "size,queue,stack,scan\n";
+    cout << "Running Benchmark: linked Queue/Stack push+pop and sequential scan...\n";
+
+    for (int n : sizes) {
+        benchmark_linked(n, out_linked);
+    }
+    out_linked.close();
+    cout << "---------------------------\n";
+
+    ofstream out_ring("results_ring.csv");
+    out_ring << "size,linked_queue,ring_queue,linked_stack,ring_stack,linked_deque,ring_deque\n";
+    cout << "Running Benchmark: linked vs ring-buffer Queue/Stack/Deque throughput...\n";
+
+    for (int n : sizes) {
+        benchmark_ring(n, out_ring);
+    }
+    out_ring.close();
+    cout << "---------------------------\n";
+
+    ofstream out_unrolled("results_unrolled.csv");
+    out_unrolled << "size,linked_build,unrolled_build,linked_scan,unrolled_scan,linked_copy,unrolled_copy,linked_insert,unrolled_insert\n";
+    cout << "Running Benchmark: LinkedSequence over LinkedList vs UnrolledLinkedList...\n";
+
+    for (int n : sizes) {
+        benchmark_unrolled(n, out_unrolled);
+    }
+    out_unrolled.close();
+    cout << "---------------------------\n";
+
+    ofstream out_pool("results_nodepool.csv");
+    out_pool << "size,heap_build,pool_build,heap_copy,pool_copy,heap_clear,pool_clear\n";
+    cout << "Running Benchmark: LinkedList nodes from the heap vs NodePool...\n";
+
+    for (int n : sizes) {
+        benchmark_node_pool(n, out_pool);
+    }
+    out_pool.close();
+    cout << "---------------------------\n";
+
+    ofstream out_mpmc("results_mpmc.csv");
+    out_mpmc << "pairs,mutex_queue,mpmc_queue\n";
+    cout << "Running Benchmark: producer/consumer through mutex+Queue vs MPMCQueue...\n";
+
+    int pair_counts[] = { 1, 2, 4, 8 };
+    for (int pairs : pair_counts) {
+        benchmark_mpmc(pairs, 1000000, out_mpmc);
+    }
+    out_mpmc.close();
+    cout << "---------------------------\n";
+    cout << "All done. Results written to results_containers.csv, results_tape.csv, results_materialised.csv, results_slices.csv, results_linked.csv, results_ring.csv, results_unrolled.csv, results_nodepool.csv and results_mpmc.csv\n";
+    return 0;
+}
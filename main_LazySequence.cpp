@@ -6,6 +6,7 @@
 #include <functional>
 #include <algorithm>
 #include <utility>
+#include <fstream>
 
 #include "LazySequence.h"
 #include "ArraySequence.h"
@@ -108,6 +109,7 @@ int main() {
         cout << "10 - Reduce (sum for finite sequence)\n";
         cout << "11 - Show materialized elements of a sequence\n";
         cout << "12 - List sequences\n";
+        cout << "13 - Dump smart pointer stats to results_pointer_stats.csv\n";
         cout << "0  - Exit\n";
         cout << "Choose command: ";
 
@@ -335,6 +337,13 @@ int main() {
                          << (seqs[i].HasGenerator() ? " (Generator)" : " (Finite)") << "\n";
                 }
             }
+            else if (cmd == 13) {
+                if (!SmartPointerStats::Enabled) cout << "Built without SMARTPOINTER_STATS; counters are zero.\n";
+                std::ofstream out("results_pointer_stats.csv");
+                SmartPointerStats::DumpCSV(out);
+                cout << "live control blocks=" << SmartPointerStats::Live()
+                     << " peak=" << SmartPointerStats::Peak() << "\n";
+            }
             else {
                 cout << "Unknown command\n";
             }
@@ -2,6 +2,9 @@
 #include <fstream>
 #include <chrono>
 #include <utility> 
+#include <thread>
+#include <mutex>
+#include <vector>
 #include "SmartPointer.h"      
 #include "MutableArraySequence.h" 
 
@@ -11,6 +14,9 @@ using namespace std::chrono;
 
 using ObjectCount = long long; 
 
+// Keeps the optimizer from eliding the new/delete pairs under test.
+static int* volatile benchmark_sink;
+
 
 void test_unique_ptr() {
     cout << "=== Testing UniquePtr ===\n";
@@ -48,12 +54,79 @@ void test_shared_ptr() {
     cout << "sp_seq3 last element: " << sp_seq3->GetLast() << "\n";
 }
 
+void test_weak_ptr() {
+    cout << "=== Testing WeakPtr ===\n";
+
+    WeakPtr<MutableArraySequence<int>> weak;
+    {
+        SharedPtr<MutableArraySequence<int>> sp_seq(MakeShared<MutableArraySequence<int>>());
+        sp_seq->Append(7);
+        weak = sp_seq;
+        cout << "use_count with weak observer: " << sp_seq.use_count() << "\n";
+
+        SharedPtr<MutableArraySequence<int>> locked = weak.lock();
+        cout << "locked last element: " << locked->GetLast() << ", use_count: " << locked.use_count() << "\n";
+    }
+    cout << "expired after owners dropped: " << (weak.expired() ? "yes" : "no") << "\n";
+    if (!weak.lock()) cout << "lock() on expired WeakPtr is empty\n";
+}
+
+struct CountedNode : RefCounted<> {
+    int value;
+    explicit CountedNode(int v) : value(v) {}
+};
+
+void test_intrusive_ptr() {
+    cout << "=== Testing IntrusivePtr ===\n";
+
+    IntrusivePtr<CountedNode> node = MakeIntrusive<CountedNode>(5);
+    SharedPtr<CountedNode> shared = node.share();
+    cout << "value: " << node->value << ", use_count shared by both owners: " << node.use_count() << "\n";
+    shared.reset();
+    cout << "use_count after SharedPtr reset: " << node.use_count() << "\n";
+}
+
+void test_atomic_shared_ptr() {
+    cout << "=== Testing AtomicSharedPtr ===\n";
+
+    typedef SharedPtr<int, AtomicRefCount> Counter;
+    AtomicSharedPtr<int, AtomicRefCount> slot(MakeSharedWith<int, AtomicRefCount>(0));
+
+    vector<thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&slot]() {
+            for (int i = 0; i < 1000; ++i) {
+                Counter current = slot.load();
+                while (!slot.compare_exchange_strong(current, MakeSharedWith<int, AtomicRefCount>(*current + 1))) {}
+            }
+        });
+    }
+    for (thread& th : writers) th.join();
+    cout << "value after 4x1000 compare-exchange increments: " << *slot.load() << "\n";
+}
+
+void test_epoch_reclamation() {
+    cout << "=== Testing EpochRefCount ===\n";
+
+    AtomicSharedPtr<int, EpochRefCount> slot(MakeSharedWith<int, EpochRefCount>(1));
+    {
+        EpochGuard pin;
+        int* seen = slot.peek();
+        slot.store(MakeSharedWith<int, EpochRefCount>(2));
+        EpochDomain::Global().Collect();
+        cout << "pinned reader still sees: " << *seen << " (pending " << EpochDomain::Global().PendingCount() << ")\n";
+    }
+    EpochDomain::Global().Collect();
+    cout << "after unpin, pending: " << EpochDomain::Global().PendingCount() << "\n";
+}
+
 
 void benchmark_object_lifecycle(ObjectCount n, ofstream& out) {
     auto start = high_resolution_clock::now();
     for (ObjectCount i = 0; i < n; ++i) {
 
         int* p = new int((int)i);
+        benchmark_sink = p;
         delete p;
     }
     auto end = high_resolution_clock::now();
@@ -63,6 +136,7 @@ void benchmark_object_lifecycle(ObjectCount n, ofstream& out) {
     for (ObjectCount i = 0; i < n; ++i) {
 
         UniquePtr<int> up_seq(MakeUnique<int>((int)i));
+        benchmark_sink = up_seq.get();
     } 
     end = high_resolution_clock::now();
     auto unique_time = duration_cast<milliseconds>(end - start).count();
@@ -72,13 +146,86 @@ void benchmark_object_lifecycle(ObjectCount n, ofstream& out) {
     for (ObjectCount i = 0; i < n; ++i) {
 
         SharedPtr<int> sp_seq = MakeShared<int>((int)i);
+        benchmark_sink = sp_seq.get();
     } 
     end = high_resolution_clock::now();
     auto shared_time = duration_cast<milliseconds>(end - start).count();
 
+    // Separate object and control block allocations, i.e. what MakeShared did
+    // before the control block was fused with the object.
+    start = high_resolution_clock::now();
+    for (ObjectCount i = 0; i < n; ++i) {
+
+        SharedPtr<int> sp_seq(new int((int)i));
+        benchmark_sink = sp_seq.get();
+    } 
+    end = high_resolution_clock::now();
+    auto separate_time = duration_cast<milliseconds>(end - start).count();
+
+
+    // Fused block, but from operator new instead of the default pool.
+    start = high_resolution_clock::now();
+    for (ObjectCount i = 0; i < n; ++i) {
+
+        SharedPtr<int> sp_seq = AllocateShared<int>(HeapAllocator(), (int)i);
+        benchmark_sink = sp_seq.get();
+    } 
+    end = high_resolution_clock::now();
+    auto heap_time = duration_cast<milliseconds>(end - start).count();
 
-    cout << "[Lifecycle Test] " << n << " objects: raw=" << raw_time << "ms, unique=" << unique_time << "ms, shared=" << shared_time << "ms\n";
-    out << n << "," << raw_time << "," << unique_time << "," << shared_time << "\n";
+
+    cout << "[Lifecycle Test] " << n << " objects: raw=" << raw_time << "ms, unique=" << unique_time << "ms, shared=" << shared_time
+         << "ms, shared_separate=" << separate_time << "ms, shared_heap=" << heap_time << "ms\n";
+    out << n << "," << raw_time << "," << unique_time << "," << shared_time << "," << separate_time << "," << heap_time << "\n";
+}
+
+
+// Every thread repeatedly copies and drops a handle to one shared object.
+// The non-atomic pointer needs a global mutex around each copy/release,
+// the atomic one is copied lock-free.
+void benchmark_refcount_contention(int threads, ObjectCount copiesPerThread, ofstream& out) {
+    SharedPtr<int, NonAtomicRefCount> plainRoot = MakeSharedWith<int, NonAtomicRefCount>(42);
+    mutex rootMutex;
+
+    auto start = high_resolution_clock::now();
+    {
+        vector<thread> pool;
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back([&]() {
+                for (ObjectCount i = 0; i < copiesPerThread; ++i) {
+                    rootMutex.lock();
+                    SharedPtr<int, NonAtomicRefCount> local = plainRoot;
+                    rootMutex.unlock();
+                    lock_guard<mutex> guard(rootMutex);
+                    local.reset();
+                }
+            });
+        }
+        for (thread& th : pool) th.join();
+    }
+    auto end = high_resolution_clock::now();
+    auto mutex_time = duration_cast<milliseconds>(end - start).count();
+
+    SharedPtr<int, AtomicRefCount> atomicRoot = MakeSharedWith<int, AtomicRefCount>(42);
+
+    start = high_resolution_clock::now();
+    {
+        vector<thread> pool;
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back([&]() {
+                for (ObjectCount i = 0; i < copiesPerThread; ++i) {
+                    SharedPtr<int, AtomicRefCount> local = atomicRoot;
+                }
+            });
+        }
+        for (thread& th : pool) th.join();
+    }
+    end = high_resolution_clock::now();
+    auto atomic_time = duration_cast<milliseconds>(end - start).count();
+
+    cout << "[Contention Test] " << threads << " threads x " << copiesPerThread << " copies: non-atomic+mutex="
+         << mutex_time << "ms, atomic=" << atomic_time << "ms\n";
+    out << threads << "," << mutex_time << "," << atomic_time << "\n";
 }
 
 
@@ -88,10 +235,19 @@ int main() {
     cout << "---------------------------\n";
     test_shared_ptr();
     cout << "---------------------------\n";
+    test_weak_ptr();
+    cout << "---------------------------\n";
+    test_intrusive_ptr();
+    cout << "---------------------------\n";
+    test_atomic_shared_ptr();
+    cout << "---------------------------\n";
+
+    test_epoch_reclamation();
+    cout << "---------------------------\n";
 
 
     ofstream out_lifecycle("results.csv"); 
-    out_lifecycle << "size,raw,unique,shared\n";
+    out_lifecycle << "size,raw,unique,shared,shared_separate,shared_heap\n";
     cout << "Running Benchmark: Object Lifecycle...\n";
 
 
@@ -108,7 +264,18 @@ int main() {
     }
     out_lifecycle.close();
     cout << "---------------------------\n";
-    cout << "All done. Results written to results.csv\n";
+
+    ofstream out_contention("results_threads.csv");
+    out_contention << "threads,non_atomic_mutex,atomic\n";
+    cout << "Running Benchmark: Refcount Contention...\n";
+
+    int thread_counts[] = { 1, 2, 4, 8, 16, 32, 64 };
+    for (int threads : thread_counts) {
+        benchmark_refcount_contention(threads, 200000, out_contention);
+    }
+    out_contention.close();
+    cout << "---------------------------\n";
+    cout << "All done. Results written to results.csv and results_threads.csv\n";
 
     cout << "Attempting to run visualization...\n";
     system("/opt/miniconda3/envs/visualizationlibraries/bin/python vizualisation.py");
@@ -11,6 +11,8 @@ plt.figure(figsize=(12, 6),dpi=150)
 plt.plot(df["size"], df["raw"], label="Raw pointer", marker='o')
 plt.plot(df["size"], df["unique"], label="UniquePtr", marker='o')
 plt.plot(df["size"], df["shared"], label="SharedPtr", marker='o')
+plt.plot(df["size"], df["shared_separate"], label="SharedPtr (separate control block)", marker='o')
+plt.plot(df["size"], df["shared_heap"], label="SharedPtr (operator new, no pool)", marker='o')
 
 
 plt.xlabel("Array size")